@@ -20,6 +20,7 @@ struct _Delivery
 	char *name;
 	char *product_name;
 	Queue *plan;
+	VertexArena *arena;	/* Created by delivery_getArena, NULL until then */
 };
 
 Delivery *delivery_init(char *name, char *productName)
@@ -63,6 +64,8 @@ Delivery *delivery_init(char *name, char *productName)
 		return NULL;
 	}
 
+	d->arena = NULL;
+
 	return d;
 }
 
@@ -80,6 +83,7 @@ void delivery_free(void *p)
 	free(d->name);
 	free(d->product_name);
 	queue_free(d->plan);
+	vertex_arena_free(d->arena);
 	free(d);
 }
 
@@ -128,6 +132,21 @@ Queue *delivery_getPlan(Delivery *d)
 	return d->plan;
 }
 
+VertexArena *delivery_getArena(Delivery *d)
+{
+	if (d == NULL)
+	{
+		return NULL;
+	}
+
+	if (d->arena == NULL)
+	{
+		d->arena = vertex_arena_init();
+	}
+
+	return d->arena;
+}
+
 Status delivery_add(FILE *pf, Delivery *d, void *p, p_element_print f)
 {
 	if (!d || !p || !f)
@@ -176,6 +195,50 @@ Status delivery_run_plan(FILE *pf, Delivery *d, p_element_print fprint, p_elemen
 	return OK;
 }
 
+Status delivery_run_plan_buffered(FILE *pf, Delivery *d, p_outbuf_ele_write fput, p_element_free ffree)
+{
+	void *element;
+	char *data;
+	OutBuf ob;
+	long written;
+
+	if (!pf || !d || !fput || !ffree)
+	{
+		return ERROR;
+	}
+
+	if (!(data = (char *)malloc(OUTBUF_BLOCK)))
+	{
+		return ERROR;
+	}
+
+	outbuf_init(&ob, pf, data, OUTBUF_BLOCK);
+	outbuf_putString(&ob, "--> running delivery plan for ");
+	outbuf_putString(&ob, d->name);
+	outbuf_putChar(&ob, ':');
+
+	while (!queue_isEmpty(d->plan))
+	{
+		element = queue_pop(d->plan);
+		if (element)
+		{
+			outbuf_putString(&ob, "\n--> delivering ");
+			outbuf_putString(&ob, delivery_getProductName(d));
+			outbuf_putString(&ob, " requested by ");
+			outbuf_putString(&ob, delivery_getName(d));
+			outbuf_putString(&ob, " to: ");
+			fput(&ob, element);
+			ffree(element);
+		}
+	}
+
+	outbuf_putString(&ob, "\n--> delivery plan completed.\n");
+	written = outbuf_flush(&ob);
+	free(data);
+
+	return written < 0 ? ERROR : OK;
+}
+
 int delivery_cmp(const void *p1, const void *p2)
 {
 	int c = 0;
@@ -110,6 +110,22 @@ const char *delivery_getProductName(const Delivery *d);
  */
 Queue *delivery_getPlan(Delivery *d);
 
+/**
+ * @brief Gets the vertex arena owned by this delivery.
+ * @author Izan Robles
+ *
+ * The arena is created on the first call and freed by delivery_free, so
+ * vertices taken from it with vertex_arena_initFromString need no freeing
+ * of their own: vertex_arena_release is the free function to pass to
+ * delivery_run_plan and delivery_free_products. Copies of the delivery
+ * share its vertices, so they must be freed first.
+ *
+ * @param d Delivery pointer
+ *
+ * @return Returns the arena, or NULL in case of error.
+ */
+VertexArena *delivery_getArena(Delivery *d);
+
 /**
  * @brief Adds a location to a delivery.
  * @author Izan Robles
@@ -136,6 +152,20 @@ Status delivery_add(FILE *pf, Delivery *d, void *p, p_element_print f);
  */
 Status delivery_run_plan(FILE *pf, Delivery *d, p_element_print fprint, p_element_free ffree);
 
+/**
+ * @brief Simulates running the plan associated to a delivery, like
+ * delivery_run_plan, with every line put in one OutBuf.
+ * @author Izan Robles
+ *
+ * @param pf File descriptor where the simulation will be shown.
+ * @param d Delivery pointer
+ * @param fput Function pointer to put elements of the delivery plan in an OutBuf
+ * @param ffree Function pointer to free elements in the delivery plan
+ *
+ * @return Returns OK or ERROR. The plan is not run if there is no memory for the buffer.
+ */
+Status delivery_run_plan_buffered(FILE *pf, Delivery *d, p_outbuf_ele_write fput, p_element_free ffree);
+
 /**
  * @brief Compares two deliveries.
  * @author Profesores EDAT
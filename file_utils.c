@@ -1,44 +1,399 @@
-/**
- * @file  file_utils.c
- * @author Izan Robles
- * @brief Utils for different datatypes
- */
-
-
-#include "file_utils.h"
-
-/* -----------------------------------------  FLOAT  ----------------------------------------- */
-
-int _float_print(FILE *pf, const void *a)
-{
-    if (!pf || !a)
-        return -1;
-    return fprintf(pf, "%.2f", *(float *)a);
-}
-
-int float_cmp(const void *a, const void *b)
-{
-    float fa;
-    float fb;
-
-    if (!a || !b)
-    {
-        return -2;
-    }
-
-    fa = *(float *)a;
-    fb = *(float *)b;
-
-    if (fa > fb)
-    {
-        return 1;
-    }
-    else if (fa < fb)
-    {
-        return -1;
-    }
-    else
-    {
-        return 0;
-    }
-}
\ No newline at end of file
+/**
+ * @file  file_utils.c
+ * @author Izan Robles
+ * @brief Utils for different datatypes
+ */
+
+
+#include "file_utils.h"
+#include <string.h>
+#include <ctype.h>
+
+/* Size of the blocks read and written by float_readArray and float_writeArray */
+#define FLOAT_IO_BLOCK 16384
+
+/* Longest token float_parseArray hands to sscanf */
+#define FLOAT_TOKEN_MAX 64
+
+/* Powers of ten that are exact in a float */
+static const float _float_pow10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+
+static unsigned int _float_key(float f, int order);
+static size_t _float_parseToken(const char *s, size_t len, float *value);
+
+/* -----------------------------------------  FLOAT  ----------------------------------------- */
+
+int _float_print(FILE *pf, const void *a)
+{
+    if (!pf || !a)
+        return -1;
+    return fprintf(pf, "%.2f", *(float *)a);
+}
+
+void float_write(OutBuf *ob, const void *a)
+{
+    char s[FLOAT_FIXED_MAX];
+
+    if (!ob || !a)
+        return;
+    outbuf_putChars(ob, s, float_formatFixed(s, *(const float *)a));
+}
+
+int float_cmp(const void *a, const void *b)
+{
+    float fa;
+    float fb;
+
+    if (!a || !b)
+    {
+        return -2;
+    }
+
+    fa = *(float *)a;
+    fb = *(float *)b;
+
+    if (fa > fb)
+    {
+        return 1;
+    }
+    else if (fa < fb)
+    {
+        return -1;
+    }
+    else
+    {
+        return 0;
+    }
+}
+/* Unsigned key with the order of float_cmp: negative values get their bits
+ * flipped and positive ones their sign bit set. -0.0 has the key of 0.0 */
+static unsigned int _float_key(float f, int order)
+{
+    unsigned int bits = 0;
+
+    if (f != 0.0f)
+    {
+        memcpy(&bits, &f, sizeof(bits));
+    }
+
+    bits = (bits & 0x80000000U) ? ~bits : (bits | 0x80000000U);
+
+    return order == -1 ? ~bits : bits;
+}
+
+int float_radixSort(float *a, size_t n, int order)
+{
+    size_t count[4][256];
+    size_t sum, tmp, i;
+    float *buf, *src, *dst, *swap;
+    unsigned int key;
+    int pass, d;
+
+    if ((!a && n > 0) || (order != 1 && order != -1) || sizeof(unsigned int) != sizeof(float))
+    {
+        return -1;
+    }
+
+    if (n < 2)
+    {
+        return 0;
+    }
+
+    if (!(buf = (float *)malloc(n * sizeof(float))))
+    {
+        return -1;
+    }
+
+    /* One read of the data counts the digits of every pass */
+    memset(count, 0, sizeof(count));
+    for (i = 0; i < n; i++)
+    {
+        key = _float_key(a[i], order);
+        count[0][key & 0xFF]++;
+        count[1][(key >> 8) & 0xFF]++;
+        count[2][(key >> 16) & 0xFF]++;
+        count[3][key >> 24]++;
+    }
+
+    src = a;
+    dst = buf;
+    for (pass = 0; pass < 4; pass++)
+    {
+        key = _float_key(a[0], order);
+        if (count[pass][(key >> (8 * pass)) & 0xFF] == n)
+        {
+            continue;
+        }
+
+        for (d = 0, sum = 0; d < 256; d++)
+        {
+            tmp = count[pass][d];
+            count[pass][d] = sum;
+            sum += tmp;
+        }
+
+        for (i = 0; i < n; i++)
+        {
+            key = _float_key(src[i], order);
+            dst[count[pass][(key >> (8 * pass)) & 0xFF]++] = src[i];
+        }
+
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != a)
+    {
+        memcpy(a, src, n * sizeof(float));
+    }
+
+    free(buf);
+
+    return 0;
+}
+
+/* Parses the token of len characters at s, returns len if it is a float
+ * and 0 otherwise. A mantissa of 24 bits and a power of ten up to 1e10
+ * are exact in a float, so their quotient is rounded once, as strtof does */
+static size_t _float_parseToken(const char *s, size_t len, float *value)
+{
+    char token[FLOAT_TOKEN_MAX];
+    unsigned long m = 0;
+    size_t i = 0;
+    int digits = 0, decimals = 0, point = 0, chars = 0;
+
+    if (s[i] == '-' || s[i] == '+')
+    {
+        i++;
+    }
+
+    for (; i < len && m <= 16777216UL; i++)
+    {
+        if (s[i] >= '0' && s[i] <= '9')
+        {
+            m = m * 10 + (s[i] - '0');
+            digits++;
+            decimals += point;
+        }
+        else if (s[i] == '.' && !point)
+        {
+            point = 1;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (i == len && digits > 0 && m <= 16777216UL && decimals <= 10)
+    {
+        *value = (float)m / _float_pow10[decimals];
+        if (s[0] == '-')
+        {
+            *value = -*value;
+        }
+        return len;
+    }
+
+    /* Exponents, long mantissas, inf and nan */
+    if (len >= FLOAT_TOKEN_MAX)
+    {
+        return 0;
+    }
+    memcpy(token, s, len);
+    token[len] = '\0';
+
+    if (sscanf(token, "%f%n", value, &chars) != 1 || (size_t)chars != len)
+    {
+        return 0;
+    }
+
+    return len;
+}
+
+size_t float_parseArray(const char *s, size_t len, float *a, size_t n, size_t *used)
+{
+    size_t pos = 0, start, count = 0;
+
+    if (!s || (!a && n > 0))
+    {
+        if (used)
+        {
+            *used = 0;
+        }
+        return 0;
+    }
+
+    while (count < n)
+    {
+        while (pos < len && isspace((unsigned char)s[pos]))
+        {
+            pos++;
+        }
+        if (pos == len)
+        {
+            break;
+        }
+
+        for (start = pos; pos < len && !isspace((unsigned char)s[pos]); pos++);
+
+        if (_float_parseToken(s + start, pos - start, &a[count]) == 0)
+        {
+            pos = start;
+            break;
+        }
+        count++;
+    }
+
+    if (used)
+    {
+        *used = pos;
+    }
+
+    return count;
+}
+
+size_t float_readArray(FILE *pf, float *a, size_t n)
+{
+    char buf[FLOAT_IO_BLOCK];
+    size_t fill = 0, got, cut, used, count = 0, parsed;
+    int end = 0;
+
+    if (!pf || (!a && n > 0))
+    {
+        return 0;
+    }
+
+    while (count < n && !(end && fill == 0))
+    {
+        if (!end)
+        {
+            got = fread(buf + fill, 1, FLOAT_IO_BLOCK - fill, pf);
+            end = got < FLOAT_IO_BLOCK - fill;
+            fill += got;
+        }
+
+        /* A token that touches the end of the block may go on in the next one */
+        cut = fill;
+        if (!end)
+        {
+            while (cut > 0 && !isspace((unsigned char)buf[cut - 1]))
+            {
+                cut--;
+            }
+            if (cut == 0)
+            {
+                cut = fill;
+            }
+        }
+
+        parsed = float_parseArray(buf, cut, a + count, n - count, &used);
+        count += parsed;
+
+        /* Something that is not a float */
+        if (parsed == 0 && used < cut && count < n)
+        {
+            break;
+        }
+
+        memmove(buf, buf + used, fill - used);
+        fill -= used;
+
+        if (end && parsed == 0)
+        {
+            break;
+        }
+    }
+
+    return count;
+}
+
+int float_formatFixed(char *s, float f)
+{
+    char digits[16];
+    unsigned int bits = 0;
+    unsigned long r;
+    double x = f, frac;
+    int len = 0, nd = 0;
+
+    if (!s)
+    {
+        return -1;
+    }
+
+    if (x != x || x > 42949672.0 || x < -42949672.0 || sizeof(bits) != sizeof(f))
+    {
+        return sprintf(s, "%.2f", x);
+    }
+
+    memcpy(&bits, &f, sizeof(bits));
+    if (bits & 0x80000000U)
+    {
+        s[len++] = '-';
+        x = -x;
+    }
+
+    /* Exact: the 24 bits of a float times the 7 bits of 100 fit in a double.
+     * Ties are rounded to even, like printf does */
+    x *= 100.0;
+    r = (unsigned long)x;
+    frac = x - (double)r;
+    if (frac > 0.5 || (frac == 0.5 && (r & 1)))
+    {
+        r++;
+    }
+
+    do
+    {
+        digits[nd++] = (char)('0' + r % 10);
+        r /= 10;
+    } while (r > 0 || nd < 3);
+
+    while (nd > 0)
+    {
+        if (nd == 2)
+        {
+            s[len++] = '.';
+        }
+        s[len++] = digits[--nd];
+    }
+    s[len] = '\0';
+
+    return len;
+}
+
+long float_writeArray(FILE *pf, const float *a, size_t n, char sep)
+{
+    char buf[FLOAT_IO_BLOCK];
+    size_t fill = 0, i;
+    long total = 0;
+
+    if (!pf || (!a && n > 0))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        if (fill + FLOAT_FIXED_MAX + 1 > FLOAT_IO_BLOCK)
+        {
+            if (fwrite(buf, 1, fill, pf) != fill)
+            {
+                return -1;
+            }
+            total += fill;
+            fill = 0;
+        }
+
+        fill += float_formatFixed(buf + fill, a[i]);
+        buf[fill++] = sep;
+    }
+
+    if (fill > 0 && fwrite(buf, 1, fill, pf) != fill)
+    {
+        return -1;
+    }
+
+    return total + fill;
+}
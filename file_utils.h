@@ -9,6 +9,12 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include "outbuf.h"
+
+/**
+ * Room needed by float_formatFixed for any float, terminator included.
+ */
+#define FLOAT_FIXED_MAX 48
 
 /* -----------------------------------------  FLOAT  ----------------------------------------- */
 
@@ -23,6 +29,15 @@
  **/
 int _float_print(FILE *pf, const void *a);
 
+/**
+ * @brief Puts a float number in an OutBuf, in the format of _float_print.
+ * @author Izan Robles
+ *
+ * @param ob OutBuf where the float is put
+ * @param a pointer to float to be put
+ **/
+void float_write(OutBuf *ob, const void *a);
+
 /**
  * @brief Compares to float numbers.
  * @author Izan Robles
@@ -34,4 +49,90 @@ int _float_print(FILE *pf, const void *a);
  **/
 int float_cmp(const void *a, const void *b);
 
+/**
+ * @brief Sorts an array of floats with a radix sort on their bits.
+ * @author Izan Robles
+ *
+ * Gives the order of float_cmp in O(n): four stable passes of one byte
+ * each, skipping the bytes that are the same in every value. Elements
+ * that compare equal, including 0.0 and -0.0, keep their relative order,
+ * as they would with list_pushInOrder. NaN values are not supported.
+ *
+ * @param a array to sort
+ * @param n number of elements of a
+ * @param order 1 for a crescent order, -1 for a decrescent one
+ *
+ * @return 0 if the array was sorted, -1 if an error occured
+ **/
+int float_radixSort(float *a, size_t n, int order);
+
+/**
+ * @brief Parses the floats written in a buffer, separated by white space.
+ * @author Izan Robles
+ *
+ * Plain decimals of up to 7 significant digits, like "-12.34", are
+ * converted without going through the C library, with the same result
+ * as fscanf with "%f". Any other number is handed to sscanf. Parsing
+ * stops after n values, at the end of the buffer or at the first token
+ * that is not a float.
+ *
+ * @param s buffer to parse, it does not need to be NUL terminated
+ * @param len number of characters of s
+ * @param a array where the values are stored
+ * @param n maximum number of values to store in a
+ * @param used if not NULL, number of characters of s consumed
+ *
+ * @return number of values stored in a
+ **/
+size_t float_parseArray(const char *s, size_t len, float *a, size_t n, size_t *used);
+
+/**
+ * @brief Reads n floats from a file, separated by white space.
+ * @author Izan Robles
+ *
+ * Reads the file in blocks and parses them with float_parseArray, which
+ * replaces a fscanf call per value. The file is read ahead, so the text
+ * after the last value may be consumed too.
+ *
+ * @param pf file to read from
+ * @param a array where the values are stored
+ * @param n number of values to read
+ *
+ * @return number of values read, less than n if the file ends or holds
+ * something that is not a float
+ **/
+size_t float_readArray(FILE *pf, float *a, size_t n);
+
+/**
+ * @brief Writes a float with two decimals, like sprintf with "%.2f".
+ * @author Izan Robles
+ *
+ * Values below 4.2e7 in absolute value are formatted with integer
+ * arithmetic, any other one is handed to sprintf.
+ *
+ * @param s buffer of at least FLOAT_FIXED_MAX characters
+ * @param f float to format
+ *
+ * @return number of characters written, not counting the terminator
+ **/
+int float_formatFixed(char *s, float f);
+
+/**
+ * @brief Prints an array of floats with two decimals, each one followed
+ * by a separator.
+ * @author Izan Robles
+ *
+ * Gives the output of _float_print and fprintf(pf, "%c", sep) for every
+ * element, formatted with float_formatFixed in a buffer that is written
+ * with one fwrite every time it fills.
+ *
+ * @param pf file to print the floats
+ * @param a array of floats
+ * @param n number of elements of a
+ * @param sep character printed after every float
+ *
+ * @return number of characters printed or -1 if an error occured
+ **/
+long float_writeArray(FILE *pf, const float *a, size_t n, char sep);
+
 #endif
@@ -0,0 +1,167 @@
+/**
+ * @brief Implementation of float_list module
+ * @author Izan Robles
+ */
+
+#include "float_list.h"
+#include <string.h>
+
+#define FLOAT_LIST_INIT_CAPACITY 16
+
+struct _FloatList
+{
+    float *values;      /* capacity slots, the list starts at front and wraps around */
+    size_t front;
+    size_t size;
+    size_t capacity;    /* Always a power of two */
+};
+
+/* Slot of the value at position i of the list */
+#define FLOAT_SLOT(pl, i) (((pl)->front + (i)) & ((pl)->capacity - 1))
+
+static Status _float_list_resize(FloatList *pl, size_t capacity);
+
+/* Moves the values to a buffer of the given capacity, unwrapping them to its start */
+static Status _float_list_resize(FloatList *pl, size_t capacity)
+{
+    float *values;
+    size_t first;
+
+    if (!(values = (float *)malloc(capacity * sizeof(float))))
+    {
+        return ERROR;
+    }
+
+    if (pl->size > 0)
+    {
+        first = pl->capacity - pl->front < pl->size ? pl->capacity - pl->front : pl->size;
+        memcpy(values, pl->values + pl->front, first * sizeof(float));
+        memcpy(values + first, pl->values, (pl->size - first) * sizeof(float));
+    }
+
+    free(pl->values);
+    pl->values = values;
+    pl->front = 0;
+    pl->capacity = capacity;
+
+    return OK;
+}
+
+FloatList *float_list_new()
+{
+    FloatList *pl = (FloatList *)malloc(sizeof(FloatList));
+
+    if (pl == NULL)
+    {
+        return NULL;
+    }
+
+    pl->values = NULL;
+    pl->front = 0;
+    pl->size = 0;
+    pl->capacity = 0;
+
+    return pl;
+}
+
+Status float_list_reserve(FloatList *pl, size_t n)
+{
+    size_t capacity;
+
+    if (pl == NULL)
+    {
+        return ERROR;
+    }
+
+    if (n <= pl->capacity)
+    {
+        return OK;
+    }
+
+    for (capacity = pl->capacity > 0 ? pl->capacity : FLOAT_LIST_INIT_CAPACITY; capacity < n; capacity *= 2);
+
+    return _float_list_resize(pl, capacity);
+}
+
+Bool float_list_isEmpty(const FloatList *pl)
+{
+    if (pl == NULL || pl->size == 0)
+    {
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+Status float_list_pushFront(FloatList *pl, float value)
+{
+    if (pl == NULL || float_list_reserve(pl, pl->size + 1) == ERROR)
+    {
+        return ERROR;
+    }
+
+    pl->front = (pl->front - 1) & (pl->capacity - 1);
+    pl->values[pl->front] = value;
+    pl->size++;
+
+    return OK;
+}
+
+Status float_list_pushBack(FloatList *pl, float value)
+{
+    if (pl == NULL || float_list_reserve(pl, pl->size + 1) == ERROR)
+    {
+        return ERROR;
+    }
+
+    pl->values[FLOAT_SLOT(pl, pl->size)] = value;
+    pl->size++;
+
+    return OK;
+}
+
+Status float_list_popFront(FloatList *pl, float *value)
+{
+    if (pl == NULL || value == NULL || pl->size == 0)
+    {
+        return ERROR;
+    }
+
+    *value = pl->values[pl->front];
+    pl->front = FLOAT_SLOT(pl, 1);
+    pl->size--;
+
+    return OK;
+}
+
+Status float_list_popBack(FloatList *pl, float *value)
+{
+    if (pl == NULL || value == NULL || pl->size == 0)
+    {
+        return ERROR;
+    }
+
+    pl->size--;
+    *value = pl->values[FLOAT_SLOT(pl, pl->size)];
+
+    return OK;
+}
+
+void float_list_free(FloatList *pl)
+{
+    if (pl)
+    {
+        free(pl->values);
+        free(pl);
+    }
+}
+
+size_t float_list_size(const FloatList *pl)
+{
+    if (pl == NULL)
+    {
+        return 0;
+    }
+
+    return pl->size;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file float_list.h
+ * @author Izan Robles
+ * @date 17 October 2026
+ * @brief Public interface for a List of floats stored by value.
+ *
+ * Same operations as List for the float case, without the pointers: the
+ * values live inline in one growable circular array, so pushing a float
+ * costs no allocation of its own. Floats kept in order go in a
+ * FloatSkipList instead.
+ *
+ * This FloatList implementation currently provides the following functionality:
+ *
+ * - Create and destroy a FloatList.
+ * - Check if a FloatList is empty.
+ * - Push a value into the front or back positions.
+ * - Pop a value from the front or back positions.
+ * - Get the number of values in a FloatList.
+ *
+ */
+
+#ifndef FLOAT_LIST_H
+#define FLOAT_LIST_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "types.h"
+
+/**
+ * FloatList type definition: a list of floats.
+ */
+typedef struct _FloatList FloatList;
+
+/**
+ * @brief Public function that creates a new FloatList.
+ * @author Izan Robles
+ *
+ * @return Returns the address of the new FloatList, or NULL in case of error.
+ */
+FloatList *float_list_new();
+
+/**
+ * @brief Public function that makes room for n values, so that pushing
+ * them does not reallocate.
+ * @author Izan Robles
+ *
+ * @param pl Pointer to the FloatList.
+ * @param n Number of values the FloatList must be able to hold.
+ *
+ * @return Status value OK if there is room, Status value ERROR otherwise.
+ */
+Status float_list_reserve(FloatList *pl, size_t n);
+
+/**
+ * @brief Public function that checks if a FloatList is empty.
+ * @author Izan Robles
+ *
+ * @param pl Pointer to the FloatList.
+ *
+ * @return Bool value TRUE if the FloatList is empty or NULL, Bool value
+ * FALSE otherwise.
+ */
+Bool float_list_isEmpty(const FloatList *pl);
+
+/**
+ * @brief Public function that pushes a value into the front position.
+ * @author Izan Robles
+ *
+ * @param pl Pointer to the FloatList.
+ * @param value Value to be inserted.
+ *
+ * @return Status value OK if the insertion could be done, Status value ERROR
+ * otherwise.
+ */
+Status float_list_pushFront(FloatList *pl, float value);
+
+/**
+ * @brief Public function that pushes a value into the back position.
+ * @author Izan Robles
+ *
+ * @param pl Pointer to the FloatList.
+ * @param value Value to be inserted.
+ *
+ * @return Status value OK if the insertion could be done, Status value ERROR
+ * otherwise.
+ */
+Status float_list_pushBack(FloatList *pl, float value);
+
+/**
+ * @brief Public function that pops the front value.
+ * @author Izan Robles
+ *
+ * @param pl Pointer to the FloatList.
+ * @param value Output, the extracted value.
+ *
+ * @return Status value OK if a value was extracted, Status value ERROR if
+ * the FloatList is empty or NULL.
+ */
+Status float_list_popFront(FloatList *pl, float *value);
+
+/**
+ * @brief Public function that pops the back value.
+ * @author Izan Robles
+ *
+ * @param pl Pointer to the FloatList.
+ * @param value Output, the extracted value.
+ *
+ * @return Status value OK if a value was extracted, Status value ERROR if
+ * the FloatList is empty or NULL.
+ */
+Status float_list_popBack(FloatList *pl, float *value);
+
+/**
+ * @brief Public function that frees a FloatList.
+ * @author Izan Robles
+ *
+ * @param pl Pointer to the FloatList.
+ */
+void float_list_free(FloatList *pl);
+
+/**
+ * @brief Public function that returns the number of values in a FloatList.
+ * @author Izan Robles
+ *
+ * @param pl Pointer to the FloatList.
+ *
+ * @return Returns the number of values, or 0 if the FloatList is NULL.
+ */
+size_t float_list_size(const FloatList *pl);
+
+#endif /* FLOAT_LIST_H */
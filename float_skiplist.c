@@ -0,0 +1,234 @@
+/**
+ * @brief Implementation of float_skiplist module
+ * @author Izan Robles
+ */
+
+#include "float_skiplist.h"
+
+/* Same level distribution as SkipList: every level holds about a quarter of the nodes of the one below */
+#define FLOAT_SKIP_MAX_LEVEL 24
+#define FLOAT_SKIP_LEVEL_BITS 2
+
+/* Nodes are taken from blocks of this many pointer sized words */
+#define FLOAT_SKIP_POOL_WORDS 8192
+
+typedef struct _FloatSkipNode
+{
+    float value;
+    struct _FloatSkipNode *next[1];     /* level pointers, the node has room for all of them */
+} FloatSkipNode;
+
+struct _FloatSkipList
+{
+    FloatSkipNode *head;    /* Holds no value, has FLOAT_SKIP_MAX_LEVEL pointers */
+    int level;              /* Levels in use */
+    size_t size;
+    int order;
+    unsigned long seed;     /* xorshift state used to pick node levels */
+    void **pool;            /* Newest node block, its first word points to the previous one */
+    size_t pool_used;       /* Words of the newest block in use */
+};
+
+static FloatSkipNode *_float_skiplist_newNode(FloatSkipList *sl, int level);
+static int _float_skiplist_randomLevel(FloatSkipList *sl);
+
+/* Takes a node of the given level from the blocks, which are only freed with the list */
+static FloatSkipNode *_float_skiplist_newNode(FloatSkipList *sl, int level)
+{
+    size_t words = (sizeof(FloatSkipNode) + (level - 1) * sizeof(FloatSkipNode *) + sizeof(void *) - 1) / sizeof(void *);
+    void **block;
+    FloatSkipNode *n;
+    int i;
+
+    if (sl->pool == NULL || sl->pool_used + words > FLOAT_SKIP_POOL_WORDS)
+    {
+        if (!(block = (void **)malloc(FLOAT_SKIP_POOL_WORDS * sizeof(void *))))
+        {
+            return NULL;
+        }
+        block[0] = sl->pool;
+        sl->pool = block;
+        sl->pool_used = 1;
+    }
+
+    n = (FloatSkipNode *)(sl->pool + sl->pool_used);
+    sl->pool_used += words;
+
+    for (i = 0; i < level; i++)
+    {
+        n->next[i] = NULL;
+    }
+
+    return n;
+}
+
+static int _float_skiplist_randomLevel(FloatSkipList *sl)
+{
+    unsigned long x = sl->seed;
+    int level = 1;
+
+    x ^= (x << 13) & 0xFFFFFFFFUL;
+    x ^= x >> 17;
+    x ^= (x << 5) & 0xFFFFFFFFUL;
+    sl->seed = x;
+
+    while (level < FLOAT_SKIP_MAX_LEVEL && (x & ((1UL << FLOAT_SKIP_LEVEL_BITS) - 1)) == 0)
+    {
+        level++;
+        x >>= FLOAT_SKIP_LEVEL_BITS;
+    }
+
+    return level;
+}
+
+FloatSkipList *float_skiplist_new(int order)
+{
+    FloatSkipList *sl = NULL;
+
+    if (order != 1 && order != -1)
+    {
+        return NULL;
+    }
+
+    if (!(sl = (FloatSkipList *)malloc(sizeof(FloatSkipList))))
+    {
+        return NULL;
+    }
+
+    sl->level = 1;
+    sl->size = 0;
+    sl->order = order;
+    sl->seed = 2463534242UL;
+    sl->pool = NULL;
+    sl->pool_used = 0;
+
+    if (!(sl->head = _float_skiplist_newNode(sl, FLOAT_SKIP_MAX_LEVEL)))
+    {
+        free(sl);
+        return NULL;
+    }
+
+    return sl;
+}
+
+Bool float_skiplist_isEmpty(const FloatSkipList *sl)
+{
+    if (sl == NULL || sl->size == 0)
+    {
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+Status float_skiplist_insert(FloatSkipList *sl, float value)
+{
+    FloatSkipNode *update[FLOAT_SKIP_MAX_LEVEL];
+    FloatSkipNode *x, *n;
+    int i, level;
+
+    if (sl == NULL)
+    {
+        return ERROR;
+    }
+
+    /* On every level, stop at the last node that value does not precede */
+    x = sl->head;
+    for (i = sl->level - 1; i >= 0; i--)
+    {
+        if (sl->order == 1)
+        {
+            while (x->next[i] != NULL && !(value < x->next[i]->value))
+            {
+                x = x->next[i];
+            }
+        }
+        else
+        {
+            while (x->next[i] != NULL && !(value > x->next[i]->value))
+            {
+                x = x->next[i];
+            }
+        }
+        update[i] = x;
+    }
+
+    level = _float_skiplist_randomLevel(sl);
+    if (!(n = _float_skiplist_newNode(sl, level)))
+    {
+        return ERROR;
+    }
+    n->value = value;
+
+    for (i = sl->level; i < level; i++)
+    {
+        update[i] = sl->head;
+    }
+    if (level > sl->level)
+    {
+        sl->level = level;
+    }
+
+    for (i = 0; i < level; i++)
+    {
+        n->next[i] = update[i]->next[i];
+        update[i]->next[i] = n;
+    }
+    sl->size++;
+
+    return OK;
+}
+
+void float_skiplist_free(FloatSkipList *sl)
+{
+    void **block;
+
+    if (sl == NULL)
+    {
+        return;
+    }
+
+    while ((block = sl->pool) != NULL)
+    {
+        sl->pool = (void **)block[0];
+        free(block);
+    }
+
+    free(sl);
+}
+
+size_t float_skiplist_size(const FloatSkipList *sl)
+{
+    if (sl == NULL)
+    {
+        return 0;
+    }
+
+    return sl->size;
+}
+
+int float_skiplist_print(FILE *fp, const FloatSkipList *sl)
+{
+    int chars_printed = 0;
+    FloatSkipNode *n;
+
+    if (fp == NULL || sl == NULL)
+    {
+        return -1;
+    }
+
+    if (float_skiplist_isEmpty(sl))
+    {
+        return fprintf(fp, "Empty list\n");
+    }
+
+    chars_printed = fprintf(fp, "Size of list: %lu\n", (unsigned long)sl->size);
+
+    for (n = sl->head->next[0]; n != NULL; n = n->next[0])
+    {
+        chars_printed += fprintf(fp, "%.2f ", n->value);
+    }
+
+    fprintf(fp, "\n");
+    return chars_printed;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file float_skiplist.h
+ * @author Izan Robles
+ * @date 17 October 2026
+ * @brief Public interface for a sorted Skip List of floats stored by value.
+ *
+ * The float case of SkipList, as FloatList is the float case of List:
+ * the values live in the nodes, they are compared directly with the
+ * rule of float_cmp instead of through a P_ele_cmp, and the nodes are
+ * taken from large blocks instead of one malloc each. Like SkipList, a
+ * value goes right before the first one it has to precede, so equal
+ * values keep their insertion order, and inserting takes O(log n)
+ * expected time.
+ *
+ * This FloatSkipList implementation currently provides the following functionality:
+ *
+ * - Create and destroy a FloatSkipList.
+ * - Insert a value in order.
+ * - Get the number of values in a FloatSkipList.
+ * - Print a FloatSkipList.
+ *
+ */
+
+#ifndef FLOAT_SKIPLIST_H
+#define FLOAT_SKIPLIST_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "types.h"
+
+/**
+ * FloatSkipList type definition: a sorted list of float values.
+ */
+typedef struct _FloatSkipList FloatSkipList;
+
+/**
+ * @brief Public function that creates a new FloatSkipList.
+ * @author Izan Robles
+ *
+ * @param order 1 for a crescent list and -1 for a decrescent list.
+ *
+ * @return Returns the address of the new FloatSkipList, or NULL in case of error.
+ */
+FloatSkipList *float_skiplist_new(int order);
+
+/**
+ * @brief Public function that checks if a FloatSkipList is empty.
+ * @author Izan Robles
+ *
+ * @param sl Pointer to the FloatSkipList.
+ *
+ * @return Bool value TRUE if the FloatSkipList is empty or NULL, Bool value
+ * FALSE otherwise.
+ */
+Bool float_skiplist_isEmpty(const FloatSkipList *sl);
+
+/**
+ * @brief Public function that inserts a value in its place.
+ * @author Izan Robles
+ *
+ * @param sl Pointer to the FloatSkipList.
+ * @param value Value to be inserted into the FloatSkipList.
+ *
+ * @return Status value OK if the insertion could be done, Status value ERROR
+ * otherwise.
+ */
+Status float_skiplist_insert(FloatSkipList *sl, float value);
+
+/**
+ * @brief Public function that frees a FloatSkipList and its values.
+ * @author Izan Robles
+ *
+ * @param sl Pointer to the FloatSkipList.
+ */
+void float_skiplist_free(FloatSkipList *sl);
+
+/**
+ * @brief Public function that returns the number of values in a FloatSkipList.
+ * @author Izan Robles
+ *
+ * @param sl Pointer to the FloatSkipList.
+ *
+ * @return Returns the number of values, or 0 if the FloatSkipList is NULL.
+ */
+size_t float_skiplist_size(const FloatSkipList *sl);
+
+/**
+ * @brief Public function that prints the content of a FloatSkipList, in
+ * order and in the same format as list_print with _float_print.
+ * @author Izan Robles
+ *
+ * @param fp Output stream.
+ * @param sl Pointer to the FloatSkipList.
+ *
+ * @return The number of characters printed, or a negative value if an
+ * error occurs.
+ */
+int float_skiplist_print(FILE *fp, const FloatSkipList *sl);
+
+#endif /* FLOAT_SKIPLIST_H */
@@ -4,753 +4,3529 @@
  * @brief Graph library
  */
 
+/* Needed for mmap, pthread barriers and friends when compiling with -ansi */
+#define _POSIX_C_SOURCE 200112L
 
 #include "graph.h"
+#include <pthread.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Vertex storage grows on demand. Indices are ints and the id table
+ * keeps twice as many slots as vertices, which bounds the graph here */
+#define MAX_VTX (1 << 29)
+
+/* Edge waiting to be merged into the CSR arrays */
+typedef struct
+{
+    int orig;
+    int dest;
+    double weight;
+} _Edge;
+
+struct _Graph
+{
+    long *ids;          /* Vertices as parallel arrays, by index: ids, */
+    Label *states;      /* labels */
+    int *tag_at;        /* and where each tag starts in tag_pool */
+    int vertex_capacity;
+    char *tag_pool;     /* Every tag, one after the other, each ending in '\0' */
+    size_t pool_size;
+    size_t pool_capacity;
+    Vertex **handles;   /* Records handed out by graph_get_vertex_array, by index. Their labels are written back */
+    Vertex **handle_ptrs;   /* The array returned, which the caller may reorder */
+    int num_handles;
+    int handle_capacity;
+    VertexArena *handle_arena;  /* Holds the records, so they never move */
+    VertexArena *scratch;   /* Holds each new vertex while it is copied in, created on first use */
+    int num_vertices;
+    int num_edges;
+    GraphStorage storage;
+    unsigned long *bits;    /* GRAPH_DENSE: vertex_capacity rows of row_words words, one bit per edge */
+    int row_words;      /* GRAPH_DENSE: words per row of bits and rbits */
+    int *offsets;       /* CSR row starts, csr_vertices + 1 entries */
+    int *neighbors;     /* CSR destination indices, sorted within each row */
+    double *weights;    /* CSR edge weights, NULL while every weight is 1 */
+    int *rev_offsets;   /* Reverse CSR (incoming edges), built on demand, NULL when out of date */
+    int *rev_neighbors;
+    unsigned long *rbits;   /* GRAPH_DENSE: transposed bit matrix, built on demand */
+    Bool weighted;      /* TRUE once an edge with a weight other than 1 is added */
+    int csr_vertices;   /* Number of vertices covered by the CSR arrays */
+    _Edge *pending;     /* Edges added since the last build */
+    int num_pending;
+    int pending_capacity;
+    long *hash_ids;     /* Open addressing id -> index table, hash_capacity slots */
+    int *hash_slots;    /* Vertex index stored in each slot, -1 if empty */
+    int hash_capacity;  /* Always a power of two, kept at most half full */
+    int *tag_slots;     /* Open addressing tag -> index table, first vertex with each tag, -1 if empty */
+    int tag_capacity;   /* Always a power of two, kept at most half full */
+    int num_tags;       /* Different tags in the graph, each stored once in tag_pool */
+    GraphSearch *search;    /* Workspace of graph_depthSearch and graph_breathSearch, created on first use */
+    Bool search_labels; /* TRUE while every label is WHITE but those of the vertices the last of them marked */
+    void *mapping;      /* Snapshot the graph was loaded from, NULL if it owns its memory */
+    size_t mapping_size;
+    pthread_mutex_t lazy_lock;  /* Serializes the builds done by const queries */
+};
+
+struct _GraphSearch
+{
+    unsigned int *marks;    /* A vertex is visited if its mark equals epoch */
+    unsigned int epoch;     /* Changes every search, so marks never need clearing */
+    int *frontier;          /* Stack used by the depth search */
+    int *order;             /* Vertices in the order they were visited */
+    int num_marked;         /* order holds every vertex the last depth or breath search marked, visited or not */
+    int *parent;            /* Vertex each visited vertex was reached from, -1 for the source */
+    unsigned long *frontier_bits;   /* Current BFS level, for bottom-up steps */
+    int capacity;           /* Number of vertices the buffers can hold */
+};
+
+#define SEARCH_VISIT(s, v) ((s)->marks[v] = (s)->epoch)
+#define SEARCH_VISITED(s, v) ((s)->marks[v] == (s)->epoch)
+
+#define BITS_PER_WORD (8 * sizeof(unsigned long))
+#define BITSET_WORDS(n) (((n) + BITS_PER_WORD - 1) / BITS_PER_WORD)
+#define BITSET_SET(set, i) ((set)[(i) / BITS_PER_WORD] |= 1UL << ((i) % BITS_PER_WORD))
+#define BITSET_TEST(set, i) (((set)[(i) / BITS_PER_WORD] >> ((i) % BITS_PER_WORD)) & 1UL)
+
+/* The parallel searches already rely on the GCC __sync builtins, so the
+ * bit counting ones are used directly too (gcc and clang have both) */
+#define WORD_POPCOUNT(w) __builtin_popcountl(w)
+#define WORD_CTZ(w) __builtin_ctzl(w)
+
+/* Walks the neighbors of a vertex in increasing index order, whatever the storage */
+typedef struct
+{
+    const Graph *g;
+    int v;
+    int pos;            /* GRAPH_SPARSE: CSR position. GRAPH_DENSE: current word of the row */
+    int end;            /* GRAPH_SPARSE: end of the row. GRAPH_DENSE: number of words in the row */
+    unsigned long word; /* GRAPH_DENSE: bits of the current word not returned yet */
+} _NeighborIter;
+
+typedef int (*_search_kernel)(const Graph *, GraphSearch *, int, int);
+
+/* Direction optimizing BFS switches to bottom-up when the edges leaving the
+ * frontier exceed the unexplored edges divided by BFS_ALPHA, and goes back to
+ * top-down when the frontier holds fewer than V / BFS_BETA vertices */
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+
+/* Binary min heap of vertex indices that knows where each vertex is, for decrease-key */
+typedef struct
+{
+    int *heap;          /* Vertex indices, heap ordered by key */
+    int *pos;           /* Position of each vertex in heap, -1 if it is not there */
+    const double *key;
+    int size;
+} _IndexHeap;
+
+/* Shared state of a parallel BFS. Workers claim PAR_CHUNK frontier
+ * vertices at a time and collect the next level in local buffers of
+ * PAR_LOCAL vertices, which are appended to next in one step */
+typedef struct
+{
+    const Graph *g;
+    volatile unsigned long *visited;
+    int *dist;
+    int *frontier;
+    int *next;
+    int frontier_size;
+    int next_size;
+    int cursor;
+    int depth;
+    Bool done;
+    pthread_mutex_t start;
+    pthread_barrier_t barrier;
+} _ParallelBfs;
+
+#define PAR_CHUNK 64
+#define PAR_LOCAL 256
+
+/* Edge lines parsed by one thread of graph_parallelReadFromFile. The
+ * lines are counted first, so each chunk writes its edges straight into
+ * its own part of one shared array. A chunk ends early at its first line
+ * that is not an edge (stopped) or that can not be added to the graph (failed) */
+typedef struct
+{
+    const Graph *g;
+    const char *begin;
+    const char *end;
+    _Edge *edges;
+    int num_lines;  /* Bound on the edges of the chunk */
+    int num_edges;
+    Bool weighted;
+    Bool stopped;
+    Bool failed;
+} _ParallelChunk;
+
+/* Chunks smaller than this are not worth a thread */
+#define PAR_MIN_CHUNK 65536
+
+#define READ_BLOCK 65536
+
+#define SNAPSHOT_MAGIC "EDATGRPH"
+#define SNAPSHOT_VERSION 3UL
+
+/**
+ * Header of a binary snapshot. It is followed by the sections it points
+ * to, each one starting at a multiple of sizeof(unsigned long): the
+ * vertex ids, labels, tag positions and tag pool, the CSR offsets,
+ * neighbors and weights (num_weights is 0 when every weight is 1), and
+ * the id hash table. All positions are in bytes from the start of the
+ * file, and the checksum covers everything after the header.
+ */
+typedef struct
+{
+    char magic[8];
+    unsigned long version;
+    unsigned long label_size;
+    unsigned long num_vertices;
+    unsigned long num_edges;
+    unsigned long num_weights;
+    unsigned long hash_capacity;
+    unsigned long pool_size;
+    unsigned long ids_at;
+    unsigned long states_at;
+    unsigned long tag_at_at;
+    unsigned long pool_at;
+    unsigned long offsets_at;
+    unsigned long neighbors_at;
+    unsigned long weights_at;
+    unsigned long hash_ids_at;
+    unsigned long hash_slots_at;
+    unsigned long total_size;
+    unsigned long checksum;
+} _SnapshotHeader;
+
+#define SNAPSHOT_ALIGN(n) (((n) + sizeof(unsigned long) - 1) / sizeof(unsigned long) * sizeof(unsigned long))
+
+/* Reads a file in large blocks and hands out lines pointing into its buffer */
+typedef struct
+{
+    FILE *f;
+    char *buf;
+    size_t capacity;
+    size_t start;   /* First character not handed out yet */
+    size_t len;     /* Characters currently held in buf */
+    Bool eof;
+    Bool failed;
+} _LineReader;
+
+#define PENDING_INIT_CAPACITY 16
+
+/* Edge lookups scan at least this many pending edges before building */
+#define PENDING_LOOKUP_MIN 64
+#define HASH_INIT_CAPACITY 16
+
+/*----------------------------------------------------------------------------------------*/
+/* Private functions */
+static int _int_cmp(const void *a, const void *b);
+static int _edge_cmp(const void *a, const void *b);
+static Status _graph_build(Graph *g);
+static Status _graph_sync(const Graph *g);
+static Bool _graph_isSynced(const Graph *g);
+static int _graph_findIndex(const Graph *g, long id);
+static Status _graph_insertVertex(Graph *g, const Vertex *v);
+static Status _graph_reserveVertices(Graph *g, int n);
+static void _graph_vertexView(const Graph *g, int i, Vertex *v);
+static void _graph_writeVertex(OutBuf *ob, const Graph *g, int i);
+static void _graph_pullLabels(const Graph *g);
+static void _graph_setLabel(Graph *g, int i, Label l);
+static VertexArena *_graph_scratch(Graph *g);
+static unsigned long _id_hash(long id);
+static Status _graph_hashResize(Graph *g, int new_capacity);
+static Status _graph_hashInsert(Graph *g, long id, int index);
+static unsigned long _tag_hash(const char *tag);
+static int _graph_findTag(const Graph *g, const char *tag);
+static Status _graph_tagReserve(Graph *g);
+static void _graph_tagInsert(Graph *g, int index);
+static Bool _graph_isBroken(const Graph *g);
+static void _graph_resetSearchLabels(Graph *g);
+static Status _graph_printSearch(Graph *g, long from_id, long to_id, _search_kernel search);
+static void _graph_iterStart(const Graph *g, int v, _NeighborIter *it);
+static int _graph_iterNext(_NeighborIter *it);
+static double _graph_iterWeight(const _NeighborIter *it);
+static int _graph_degree(const Graph *g, int v);
+static Bool _graph_hasEdge(const Graph *g, int orig, int dest);
+static int _graph_pendingLimit(const Graph *g);
+static Status _graph_lockLookup(const Graph *g);
+static Bool _graph_pendingHasEdge(const Graph *g, int orig, int dest);
+static int _graph_pendingDegree(const Graph *g, int v);
+static Status _graph_syncReverse(const Graph *g);
+static Status _graph_buildReverse(Graph *g);
+static void _search_start(GraphSearch *s);
+static int _graph_parentInFrontier(const Graph *g, int v, const unsigned long *frontier);
+static Status _reader_init(_LineReader *r, FILE *f);
+static const char *_reader_nextLine(_LineReader *r, size_t *line_len);
+static Bool _parse_long(const char **p, const char *end, long *value);
+static Bool _parse_weight(const char **p, const char *end, double *weight);
+static void _heap_swap(_IndexHeap *h, int i, int j);
+static void _heap_up(_IndexHeap *h, int i);
+static void _heap_down(_IndexHeap *h, int i);
+static void _heap_update(_IndexHeap *h, int v);
+static int _heap_pop(_IndexHeap *h);
+static void *_parallel_bfsWorker(void *arg);
+static void _graph_msbfsBatch(const Graph *g, const int *from, const int *to, int n, int *dist, unsigned long *seen, unsigned long *visit, unsigned long *next);
+static void _parallel_bfsFlush(_ParallelBfs *p, const int *local, int n);
+static void *_parallel_countWorker(void *arg);
+static void *_parallel_readWorker(void *arg);
+static void _parallel_runChunks(_ParallelChunk *chunks, int n_chunks, void *(*worker)(void *));
+static Status _graph_readVertices(Graph *g, _LineReader *r);
+static void _graph_addDenseEdge(Graph *g, int orig, int dest);
+static const char *_reader_rest(_LineReader *r, size_t *len);
+static const char *_reader_map(_LineReader *r, size_t *len, char **mapping, size_t *mapping_size);
+static unsigned long _snapshot_checksum(const unsigned long *words, size_t n_words);
+static Bool _snapshot_isValid(const _SnapshotHeader *h, size_t file_size);
+static Bool _snapshot_hasValidContents(const _SnapshotHeader *h, const char *snapshot);
+
+static int _int_cmp(const void *a, const void *b)
+{
+    int ia = *(const int *)a;
+    int ib = *(const int *)b;
+
+    return (ia > ib) - (ia < ib);
+}
+
+/* Orders edges by destination, and duplicated edges by weight */
+static int _edge_cmp(const void *a, const void *b)
+{
+    const _Edge *ea = (const _Edge *)a;
+    const _Edge *eb = (const _Edge *)b;
+
+    if (ea->dest != eb->dest)
+    {
+        return (ea->dest > eb->dest) - (ea->dest < eb->dest);
+    }
+
+    return (ea->weight > eb->weight) - (ea->weight < eb->weight);
+}
+
+/**
+ * Merges the pending edges into the CSR arrays. Every row is sorted by
+ * destination index (the order the old matrix was scanned in) and
+ * duplicated edges are dropped, so num_edges is exact after a build.
+ */
+static Status _graph_build(Graph *g)
+{
+    int *offsets = NULL;
+    int *neighbors = NULL;
+    double *weights = NULL;
+    _Edge *edges = NULL;
+    int *fill = NULL;
+    int i, k, start, end, write, total;
+
+    offsets = (int *)calloc(g->num_vertices + 1, sizeof(int));
+    fill = (int *)malloc((g->num_vertices + 1) * sizeof(int));
+    if (!offsets || !fill)
+    {
+        free(offsets);
+        free(fill);
+        return ERROR;
+    }
+
+    /* Count row lengths: current CSR rows plus pending edges */
+    for (i = 0; i < g->csr_vertices; i++)
+    {
+        offsets[i + 1] = g->offsets[i + 1] - g->offsets[i];
+    }
+    for (k = 0; k < g->num_pending; k++)
+    {
+        offsets[g->pending[k].orig + 1]++;
+    }
+    for (i = 0; i < g->num_vertices; i++)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+
+    total = offsets[g->num_vertices];
+    edges = (_Edge *)malloc((total > 0 ? total : 1) * sizeof(_Edge));
+    neighbors = (int *)malloc((total > 0 ? total : 1) * sizeof(int));
+    if (g->weighted)
+    {
+        weights = (double *)malloc((total > 0 ? total : 1) * sizeof(double));
+    }
+    if (!edges || !neighbors || (g->weighted && !weights))
+    {
+        free(offsets);
+        free(fill);
+        free(edges);
+        free(neighbors);
+        free(weights);
+        return ERROR;
+    }
+
+    /* Scatter old rows and pending edges into their rows */
+    memcpy(fill, offsets, (g->num_vertices + 1) * sizeof(int));
+    for (i = 0; i < g->csr_vertices; i++)
+    {
+        for (k = g->offsets[i]; k < g->offsets[i + 1]; k++)
+        {
+            edges[fill[i]].orig = i;
+            edges[fill[i]].dest = g->neighbors[k];
+            edges[fill[i]].weight = g->weights ? g->weights[k] : 1.0;
+            fill[i]++;
+        }
+    }
+    for (k = 0; k < g->num_pending; k++)
+    {
+        edges[fill[g->pending[k].orig]++] = g->pending[k];
+    }
+    free(fill);
+
+    /* Sort every row and compact away duplicated edges, keeping the lightest */
+    write = 0;
+    for (i = 0; i < g->num_vertices; i++)
+    {
+        start = offsets[i];
+        end = offsets[i + 1];
+        qsort(edges + start, end - start, sizeof(_Edge), _edge_cmp);
+
+        offsets[i] = write;
+        for (k = start; k < end; k++)
+        {
+            if (k == start || edges[k].dest != edges[k - 1].dest)
+            {
+                if (weights)
+                {
+                    weights[write] = edges[k].weight;
+                }
+                neighbors[write++] = edges[k].dest;
+            }
+        }
+    }
+    offsets[g->num_vertices] = write;
+    free(edges);
+
+    free(g->offsets);
+    free(g->neighbors);
+    free(g->weights);
+    free(g->rev_offsets);
+    free(g->rev_neighbors);
+    g->rev_offsets = NULL;
+    g->rev_neighbors = NULL;
+    g->offsets = offsets;
+    g->neighbors = neighbors;
+    g->weights = weights;
+    g->num_edges = write;
+
+    /* Readers that skip lazy_lock see the new arrays before the graph looks synced */
+    __sync_synchronize();
+    g->csr_vertices = g->num_vertices;
+    g->num_pending = 0;
+
+    return OK;
+}
+
+/**
+ * Makes sure the CSR arrays reflect every vertex and edge added so far.
+ * Query functions receive a const graph, but building the CSR does not
+ * change the graph contents, only its representation.
+ */
+static Status _graph_sync(const Graph *g)
+{
+    Graph *mg = (Graph *)g;
+    Status st = OK;
+
+    if (_graph_isSynced(g))
+    {
+        return OK;
+    }
+
+    /* Searches may run at the same time on one graph, only one builds */
+    pthread_mutex_lock(&mg->lazy_lock);
+    if (g->num_pending != 0 || g->csr_vertices != g->num_vertices)
+    {
+        st = _graph_build(mg);
+    }
+    pthread_mutex_unlock(&mg->lazy_lock);
+
+    return st;
+}
+
+/**
+ * TRUE if there is nothing to build, so queries can skip lazy_lock. Only
+ * a build changes that while queries run, and it publishes the arrays first.
+ */
+static Bool _graph_isSynced(const Graph *g)
+{
+    if (g->storage == GRAPH_DENSE)
+    {
+        return TRUE;
+    }
+
+    if (g->num_pending == 0 && g->csr_vertices == g->num_vertices)
+    {
+        __sync_synchronize();
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* The graph must be synced before iterating a sparse row */
+static void _graph_iterStart(const Graph *g, int v, _NeighborIter *it)
+{
+    it->g = g;
+    it->v = v;
+
+    if (g->storage == GRAPH_DENSE)
+    {
+        it->pos = 0;
+        it->end = BITSET_WORDS(g->num_vertices);
+        it->word = it->end > 0 ? g->bits[(size_t)v * g->row_words] : 0;
+    }
+    else
+    {
+        it->pos = g->offsets[v];
+        it->end = g->offsets[v + 1];
+        it->word = 0;
+    }
+}
+
+/* Returns the index of the next neighbor, or -1 when the row is exhausted */
+static int _graph_iterNext(_NeighborIter *it)
+{
+    int bit;
+
+    if (it->g->storage != GRAPH_DENSE)
+    {
+        return it->pos < it->end ? it->g->neighbors[it->pos++] : -1;
+    }
+
+    while (it->word == 0)
+    {
+        if (++it->pos >= it->end)
+        {
+            return -1;
+        }
+        it->word = it->g->bits[(size_t)it->v * it->g->row_words + it->pos];
+    }
+
+    bit = WORD_CTZ(it->word);
+    it->word &= it->word - 1;
+
+    return it->pos * BITS_PER_WORD + bit;
+}
+
+/* Weight of the edge to the neighbor last returned by _graph_iterNext */
+static double _graph_iterWeight(const _NeighborIter *it)
+{
+    if (it->g->storage == GRAPH_DENSE || it->g->weights == NULL)
+    {
+        return 1.0;
+    }
+
+    return it->g->weights[it->pos - 1];
+}
+
+static int _graph_degree(const Graph *g, int v)
+{
+    const unsigned long *row;
+    int i, count = 0;
+
+    if (g->storage != GRAPH_DENSE)
+    {
+        return v < g->csr_vertices ? g->offsets[v + 1] - g->offsets[v] : 0;
+    }
+
+    row = g->bits + (size_t)v * g->row_words;
+    for (i = 0; i < (int)BITSET_WORDS(g->num_vertices); i++)
+    {
+        count += WORD_POPCOUNT(row[i]);
+    }
+
+    return count;
+}
+
+/**
+ * Builds the incoming edges of every vertex if they are not up to date:
+ * a reverse CSR for sparse graphs, a transposed matrix for dense ones.
+ * Like _graph_sync, it only changes the representation of the graph.
+ */
+static Status _graph_syncReverse(const Graph *g)
+{
+    Graph *mg = (Graph *)g;
+    Status st;
+
+    if (_graph_sync(g) == ERROR)
+    {
+        return ERROR;
+    }
+
+    pthread_mutex_lock(&mg->lazy_lock);
+    st = _graph_buildReverse(mg);
+    pthread_mutex_unlock(&mg->lazy_lock);
+
+    return st;
+}
+
+/* Builds the incoming edges unless they are already there */
+static Status _graph_buildReverse(Graph *g)
+{
+    _NeighborIter it;
+    int *fill;
+    int i, k, v;
+
+    if (g->storage == GRAPH_DENSE)
+    {
+        if (g->rbits != NULL)
+        {
+            return OK;
+        }
+
+        if (!(g->rbits = (unsigned long *)calloc((size_t)g->vertex_capacity * g->row_words + 1, sizeof(unsigned long))))
+        {
+            return ERROR;
+        }
+
+        for (i = 0; i < g->num_vertices; i++)
+        {
+            _graph_iterStart(g, i, &it);
+            while ((v = _graph_iterNext(&it)) != -1)
+            {
+                BITSET_SET(g->rbits + (size_t)v * g->row_words, i);
+            }
+        }
+
+        return OK;
+    }
+
+    if (g->rev_offsets != NULL)
+    {
+        return OK;
+    }
+
+    g->rev_offsets = (int *)calloc(g->num_vertices + 1, sizeof(int));
+    g->rev_neighbors = (int *)malloc((g->num_edges > 0 ? g->num_edges : 1) * sizeof(int));
+    fill = (int *)malloc((g->num_vertices + 1) * sizeof(int));
+    if (!g->rev_offsets || !g->rev_neighbors || !fill)
+    {
+        free(g->rev_offsets);
+        free(g->rev_neighbors);
+        free(fill);
+        g->rev_offsets = NULL;
+        g->rev_neighbors = NULL;
+        return ERROR;
+    }
+
+    /* Counting sort by destination; rows come out sorted by origin */
+    for (k = 0; k < g->num_edges; k++)
+    {
+        g->rev_offsets[g->neighbors[k] + 1]++;
+    }
+    for (i = 0; i < g->num_vertices; i++)
+    {
+        g->rev_offsets[i + 1] += g->rev_offsets[i];
+    }
+
+    memcpy(fill, g->rev_offsets, (g->num_vertices + 1) * sizeof(int));
+    for (i = 0; i < g->num_vertices; i++)
+    {
+        for (k = g->offsets[i]; k < g->offsets[i + 1]; k++)
+        {
+            g->rev_neighbors[fill[g->neighbors[k]]++] = i;
+        }
+    }
+    free(fill);
+
+    return OK;
+}
+
+/* Returns a vertex of the frontier with an edge to v, or -1 if there is none */
+static int _graph_parentInFrontier(const Graph *g, int v, const unsigned long *frontier)
+{
+    const unsigned long *row;
+    unsigned long word;
+    int i, u;
+
+    if (g->storage == GRAPH_DENSE)
+    {
+        /* Checks a whole word of candidate parents at once */
+        row = g->rbits + (size_t)v * g->row_words;
+        for (i = 0; i < (int)BITSET_WORDS(g->num_vertices); i++)
+        {
+            if ((word = row[i] & frontier[i]) != 0)
+            {
+                return i * BITS_PER_WORD + WORD_CTZ(word);
+            }
+        }
+        return -1;
+    }
+
+    for (i = g->rev_offsets[v]; i < g->rev_offsets[v + 1]; i++)
+    {
+        u = g->rev_neighbors[i];
+        if (BITSET_TEST(frontier, u))
+        {
+            return u;
+        }
+    }
+
+    return -1;
+}
+
+static Bool _graph_hasEdge(const Graph *g, int orig, int dest)
+{
+    const int *row;
+
+    if (g->storage == GRAPH_DENSE)
+    {
+        return BITSET_TEST(g->bits + (size_t)orig * g->row_words, dest) ? TRUE : FALSE;
+    }
+
+    /* Vertices added after the last build have no CSR row yet */
+    if (orig >= g->csr_vertices)
+    {
+        return FALSE;
+    }
+
+    row = g->neighbors + g->offsets[orig];
+
+    return bsearch(&dest, row, g->offsets[orig + 1] - g->offsets[orig], sizeof(int), _int_cmp) != NULL ? TRUE : FALSE;
+}
+
+/**
+ * Pending edges that graph_connectionExists and
+ * graph_getNumberOfConnectionsFromId scan instead of building: about the
+ * square root of the graph size. Adding edges and looking them up in
+ * turns then costs a build every that many edges, which is about what
+ * the scans in between cost.
+ */
+static int _graph_pendingLimit(const Graph *g)
+{
+    unsigned long n = (unsigned long)g->num_vertices + g->num_edges, root = 1;
+
+    while (root * root < n)
+    {
+        root *= 2;
+    }
+    while (root * root > n)
+    {
+        root = (root + n / root) / 2;
+    }
+
+    return root > PENDING_LOOKUP_MIN ? (int)root : PENDING_LOOKUP_MIN;
+}
+
+/**
+ * Takes lazy_lock for a lookup in a sparse graph, building it first if
+ * it has more than _graph_pendingLimit pending edges. On OK the caller
+ * answers from the CSR rows and the pending edges and releases the lock.
+ */
+static Status _graph_lockLookup(const Graph *g)
+{
+    Graph *mg = (Graph *)g;
+
+    pthread_mutex_lock(&mg->lazy_lock);
+    if (g->num_pending > _graph_pendingLimit(g) && _graph_build(mg) == ERROR)
+    {
+        pthread_mutex_unlock(&mg->lazy_lock);
+        return ERROR;
+    }
+
+    return OK;
+}
+
+/* _graph_hasEdge for a sparse graph that may have pending edges */
+static Bool _graph_pendingHasEdge(const Graph *g, int orig, int dest)
+{
+    int k;
+
+    if (_graph_hasEdge(g, orig, dest))
+    {
+        return TRUE;
+    }
+
+    for (k = 0; k < g->num_pending; k++)
+    {
+        if (g->pending[k].orig == orig && g->pending[k].dest == dest)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* _graph_degree for a sparse graph that may have pending edges. Edges
+ * already in the CSR row or pending twice are counted once, as a build would */
+static int _graph_pendingDegree(const Graph *g, int v)
+{
+    int count = _graph_degree(g, v);
+    int k, j;
+
+    for (k = 0; k < g->num_pending; k++)
+    {
+        if (g->pending[k].orig != v || _graph_hasEdge(g, v, g->pending[k].dest))
+        {
+            continue;
+        }
+
+        for (j = 0; j < k && (g->pending[j].orig != v || g->pending[j].dest != g->pending[k].dest); j++);
+        if (j == k)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/* Sets the bit of an edge in a dense graph, counting it if it was not there */
+static void _graph_addDenseEdge(Graph *g, int orig, int dest)
+{
+    if (!_graph_hasEdge(g, orig, dest))
+    {
+        BITSET_SET(g->bits + (size_t)orig * g->row_words, dest);
+        if (g->rbits != NULL)
+        {
+            BITSET_SET(g->rbits + (size_t)dest * g->row_words, orig);
+        }
+        g->num_edges++;
+    }
+}
+
+/* Makes room for n vertices in the vertex arrays */
+static Status _graph_reserveVertices(Graph *g, int n)
+{
+    int capacity, row_words, i;
+    long *ids;
+    Label *states;
+    int *tag_at;
+    unsigned long *bits;
+
+    if (n <= g->vertex_capacity)
+    {
+        return OK;
+    }
+
+    for (capacity = g->vertex_capacity > 0 ? g->vertex_capacity : 64; capacity < n; capacity *= 2);
+
+    /* Each array is replaced as soon as it grows, so a failure leaves them usable */
+    if (!(ids = (long *)realloc(g->ids, capacity * sizeof(long))))
+    {
+        return ERROR;
+    }
+    g->ids = ids;
+
+    if (!(states = (Label *)realloc(g->states, capacity * sizeof(Label))))
+    {
+        return ERROR;
+    }
+    g->states = states;
+
+    if (!(tag_at = (int *)realloc(g->tag_at, capacity * sizeof(int))))
+    {
+        return ERROR;
+    }
+    g->tag_at = tag_at;
+
+    /* The bit matrix gets wider rows too, so it is copied row by row */
+    if (g->storage == GRAPH_DENSE)
+    {
+        row_words = BITSET_WORDS(capacity);
+        if (!(bits = (unsigned long *)calloc((size_t)capacity * row_words, sizeof(unsigned long))))
+        {
+            return ERROR;
+        }
+        for (i = 0; i < g->num_vertices; i++)
+        {
+            memcpy(bits + (size_t)i * row_words, g->bits + (size_t)i * g->row_words, g->row_words * sizeof(unsigned long));
+        }
+        free(g->bits);
+        g->bits = bits;
+        g->row_words = row_words;
+
+        /* The transposed matrix is rebuilt with the new width when needed */
+        free(g->rbits);
+        g->rbits = NULL;
+    }
+
+    g->vertex_capacity = capacity;
+
+    return OK;
+}
+
+/**
+ * Copies a vertex created by the caller into the vertex arrays. Vertices
+ * that are not valid or whose id is already taken are not stored.
+ */
+static Status _graph_insertVertex(Graph *g, const Vertex *v)
+{
+    size_t tag_len, capacity;
+    char *pool;
+    int first;
+
+    if (v == NULL || g->num_vertices == MAX_VTX || is_invalid_vertex(v))
+    {
+        return ERROR;
+    }
+    
+    if (_graph_findIndex(g, vertex_getId(v)) != -1)
+    {
+        return OK;
+    }
+
+    /* Tags already in the pool are shared, not copied again */
+    first = _graph_findTag(g, vertex_getTag(v));
+    tag_len = strlen(vertex_getTag(v)) + 1;
+    if (first == -1 && g->pool_size + tag_len > INT_MAX)
+    {
+        return ERROR;
+    }
+    if (first == -1 && g->pool_size + tag_len > g->pool_capacity)
+    {
+        for (capacity = g->pool_capacity > 0 ? g->pool_capacity : 1024; capacity < g->pool_size + tag_len; capacity *= 2);
+        if (!(pool = (char *)realloc(g->tag_pool, capacity)))
+        {
+            return ERROR;
+        }
+        g->tag_pool = pool;
+        g->pool_capacity = capacity;
+    }
+
+    if (_graph_reserveVertices(g, g->num_vertices + 1) == ERROR || (first == -1 && _graph_tagReserve(g) == ERROR)
+        || _graph_hashInsert(g, vertex_getId(v), g->num_vertices) == ERROR)
+    {
+        return ERROR;
+    }
+
+    g->ids[g->num_vertices] = vertex_getId(v);
+    g->states[g->num_vertices] = vertex_getState(v);
+    if (g->states[g->num_vertices] != WHITE)
+    {
+        g->search_labels = FALSE;
+    }
+    if (first != -1)
+    {
+        g->tag_at[g->num_vertices] = g->tag_at[first];
+    }
+    else
+    {
+        g->tag_at[g->num_vertices] = (int)g->pool_size;
+        memcpy(g->tag_pool + g->pool_size, vertex_getTag(v), tag_len);
+        g->pool_size += tag_len;
+        _graph_tagInsert(g, g->num_vertices);
+    }
+    g->num_vertices++;
+
+    return OK;
+}
+
+/* Arena for parsing new vertices. It is cleared after each one, so it never allocates again */
+static VertexArena *_graph_scratch(Graph *g)
+{
+    if (g->scratch == NULL)
+    {
+        g->scratch = vertex_arena_init();
+    }
+
+    return g->scratch;
+}
+
+/* Fills v with a copy of vertex i, so the Vertex functions can be used on it */
+static void _graph_vertexView(const Graph *g, int i, Vertex *v)
+{
+    v->id = g->ids[i];
+    strcpy(v->tag, g->tag_pool + g->tag_at[i]);
+    v->state = g->states[i];
+    v->index = i;
+}
+
+/**
+ * Copies into the graph the labels changed through the records handed
+ * out by graph_get_vertex_array. Like _graph_sync, const functions call
+ * it too: it brings the graph up to date, it does not change it.
+ */
+static void _graph_pullLabels(const Graph *g)
+{
+    Graph *mg = (Graph *)g;
+    int i;
+
+    for (i = 0; i < g->num_handles; i++)
+    {
+        if (g->handles[i]->state != g->states[i])
+        {
+            mg->states[i] = g->handles[i]->state;
+            mg->search_labels = FALSE;
+        }
+    }
+}
+
+/* Sets the label of vertex i, in its handed out record too */
+static void _graph_setLabel(Graph *g, int i, Label l)
+{
+    g->states[i] = l;
+    if (i < g->num_handles)
+    {
+        g->handles[i]->state = l;
+    }
+}
+
+/* Puts vertex i in ob in the format of vertex_print, straight from the arrays */
+static void _graph_writeVertex(OutBuf *ob, const Graph *g, int i)
+{
+    outbuf_putChar(ob, '[');
+    outbuf_putLong(ob, g->ids[i]);
+    outbuf_putChars(ob, ", ", 2);
+    outbuf_putString(ob, g->tag_pool + g->tag_at[i]);
+    outbuf_putChars(ob, ", ", 2);
+    outbuf_putLong(ob, g->states[i]);
+    outbuf_putChar(ob, ']');
+}
+
+static Status _reader_init(_LineReader *r, FILE *f)
+{
+    r->f = f;
+    r->capacity = 2 * READ_BLOCK;
+    r->start = 0;
+    r->len = 0;
+    r->eof = FALSE;
+    r->failed = FALSE;
+
+    /* One extra character keeps the data null terminated, for strtod */
+    if (!(r->buf = (char *)malloc(r->capacity + 1)))
+    {
+        return ERROR;
+    }
+    r->buf[0] = '\0';
+
+    return OK;
+}
+
+/**
+ * Returns the next line that is not blank, without its line break, or
+ * NULL at the end of the file. The line stays valid until the next call.
+ * Blocks are only copied when a line is split between two of them.
+ */
+static const char *_reader_nextLine(_LineReader *r, size_t *line_len)
+{
+    const char *line, *nl, *p;
+    char *new_buf;
+    size_t rest, n;
+
+    while (TRUE)
+    {
+        nl = r->start < r->len ? (const char *)memchr(r->buf + r->start, '\n', r->len - r->start) : NULL;
+
+        if (nl || (r->eof && r->start < r->len))
+        {
+            line = r->buf + r->start;
+            *line_len = nl ? (size_t)(nl - line) : r->len - r->start;
+            r->start += *line_len + (nl ? 1 : 0);
+
+            for (p = line; p < line + *line_len && (*p == ' ' || *p == '\t' || *p == '\r'); p++);
+            if (p < line + *line_len)
+            {
+                return line;
+            }
+            continue;
+        }
+
+        if (r->eof)
+        {
+            return NULL;
+        }
+
+        /* Keep the unfinished line and read the next block after it */
+        rest = r->len - r->start;
+        memmove(r->buf, r->buf + r->start, rest);
+        r->start = 0;
+        r->len = rest;
+
+        if (r->capacity - r->len < READ_BLOCK)
+        {
+            if (!(new_buf = (char *)realloc(r->buf, 2 * r->capacity + 1)))
+            {
+                r->failed = TRUE;
+                return NULL;
+            }
+            r->buf = new_buf;
+            r->capacity *= 2;
+        }
+
+        n = fread(r->buf + r->len, 1, r->capacity - r->len, r->f);
+        r->len += n;
+        r->buf[r->len] = '\0';
+        if (n == 0)
+        {
+            r->eof = TRUE;
+        }
+    }
+}
+
+/**
+ * Reads what is left of the file after the lines already handed out and
+ * returns it in one null terminated block of len characters, or NULL if
+ * there is not enough memory. The block stays valid until the buffer is freed.
+ */
+static const char *_reader_rest(_LineReader *r, size_t *len)
+{
+    char *new_buf;
+    size_t n;
+
+    while (!r->eof)
+    {
+        if (r->capacity - r->len < READ_BLOCK)
+        {
+            if (!(new_buf = (char *)realloc(r->buf, 2 * r->capacity + 1)))
+            {
+                r->failed = TRUE;
+                return NULL;
+            }
+            r->buf = new_buf;
+            r->capacity *= 2;
+        }
+
+        n = fread(r->buf + r->len, 1, r->capacity - r->len, r->f);
+        r->len += n;
+        r->buf[r->len] = '\0';
+        if (n == 0)
+        {
+            r->eof = TRUE;
+        }
+    }
+
+    *len = r->len - r->start;
+
+    return r->buf + r->start;
+}
+
+/**
+ * Like _reader_rest, but maps the file instead of reading it into the
+ * buffer. Returns NULL if the file can not be mapped, which is left to
+ * _reader_rest. Files that fill their last page are not mapped either:
+ * the parsers need a null character after the data, and only the zeroed
+ * end of the last page gives it.
+ */
+static const char *_reader_map(_LineReader *r, size_t *len, char **mapping, size_t *mapping_size)
+{
+    struct stat st;
+    long pos;
+    size_t unread;
+    char *m;
+
+    if (fstat(fileno(r->f), &st) == -1 || !S_ISREG(st.st_mode) || st.st_size <= 0
+        || (size_t)st.st_size % (size_t)sysconf(_SC_PAGESIZE) == 0 || (pos = ftell(r->f)) == -1)
+    {
+        return NULL;
+    }
+
+    /* The reader has taken the file up to pos, and not handed out the last unread characters */
+    unread = r->len - r->start;
+    if ((size_t)pos < unread || pos > st.st_size)
+    {
+        return NULL;
+    }
+
+    m = (char *)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(r->f), 0);
+    if (m == (char *)MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    *mapping = m;
+    *mapping_size = st.st_size;
+    *len = st.st_size - (pos - unread);
+
+    return m + (pos - unread);
+}
+
+/* Parses an integer at *p, skipping leading blanks, and moves *p past it.
+ * Out of range values are clamped, like the vertex parser does */
+static Bool _parse_long(const char **p, const char *end, long *value)
+{
+    const char *c = *p;
+    long sign = 1;
+    Bool clamped = FALSE;
+
+    while (c < end && (*c == ' ' || *c == '\t' || *c == '\r'))
+    {
+        c++;
+    }
+
+    if (c < end && (*c == '-' || *c == '+'))
+    {
+        sign = (*c == '-') ? -1 : 1;
+        c++;
+    }
+
+    if (c == end || *c < '0' || *c > '9')
+    {
+        return FALSE;
+    }
+
+    for (*value = 0; c < end && *c >= '0' && *c <= '9'; c++)
+    {
+        if (!clamped && *value > (LONG_MAX - (*c - '0')) / 10)
+        {
+            clamped = TRUE;
+        }
+        else if (!clamped)
+        {
+            *value = 10 * *value + (*c - '0');
+        }
+    }
+
+    if (clamped)
+    {
+        *value = sign > 0 ? LONG_MAX : LONG_MIN;
+    }
+    else
+    {
+        *value *= sign;
+    }
+    *p = c;
+
+    return TRUE;
+}
+
+/* Parses the optional weight at *p, which must end the line. Missing weights are 1 */
+static Bool _parse_weight(const char **p, const char *end, double *weight)
+{
+    const char *c = *p;
+    char *number_end;
+
+    while (c < end && (*c == ' ' || *c == '\t' || *c == '\r'))
+    {
+        c++;
+    }
+
+    if (c == end)
+    {
+        *weight = 1.0;
+        return TRUE;
+    }
+
+    /* The line is followed by a line break or the final null character */
+    *weight = strtod(c, &number_end);
+    if (number_end == c || number_end > end)
+    {
+        return FALSE;
+    }
+
+    /* Anything after the weight makes it a line that is not an edge */
+    for (c = number_end; c < end && (*c == ' ' || *c == '\t' || *c == '\r'); c++);
+    if (c != end)
+    {
+        return FALSE;
+    }
+
+    *p = c;
+
+    return TRUE;
+}
+
+static void _heap_swap(_IndexHeap *h, int i, int j)
+{
+    int v = h->heap[i];
+
+    h->heap[i] = h->heap[j];
+    h->heap[j] = v;
+    h->pos[h->heap[i]] = i;
+    h->pos[h->heap[j]] = j;
+}
+
+static void _heap_up(_IndexHeap *h, int i)
+{
+    while (i > 0 && h->key[h->heap[i]] < h->key[h->heap[(i - 1) / 2]])
+    {
+        _heap_swap(h, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void _heap_down(_IndexHeap *h, int i)
+{
+    int child;
+
+    while ((child = 2 * i + 1) < h->size)
+    {
+        if (child + 1 < h->size && h->key[h->heap[child + 1]] < h->key[h->heap[child]])
+        {
+            child++;
+        }
+        if (!(h->key[h->heap[child]] < h->key[h->heap[i]]))
+        {
+            break;
+        }
+        _heap_swap(h, i, child);
+        i = child;
+    }
+}
+
+/* Inserts v, or moves it up if its key has just been decreased */
+static void _heap_update(_IndexHeap *h, int v)
+{
+    if (h->pos[v] == -1)
+    {
+        h->heap[h->size] = v;
+        h->pos[v] = h->size++;
+    }
+
+    _heap_up(h, h->pos[v]);
+}
+
+static int _heap_pop(_IndexHeap *h)
+{
+    int v = h->heap[0];
+
+    _heap_swap(h, 0, --h->size);
+    h->pos[v] = -1;
+    _heap_down(h, 0);
+
+    return v;
+}
+
+/* Appends a worker's local buffer to the next level */
+static void _parallel_bfsFlush(_ParallelBfs *p, const int *local, int n)
+{
+    int at;
+
+    if (n > 0)
+    {
+        at = __sync_fetch_and_add(&p->next_size, n);
+        memcpy(p->next + at, local, n * sizeof(int));
+    }
+}
+
+/* Counts the lines of one chunk, an upper bound on its edges */
+static void *_parallel_countWorker(void *arg)
+{
+    _ParallelChunk *c = (_ParallelChunk *)arg;
+    const char *p;
+
+    c->num_lines = 0;
+    for (p = c->begin; p < c->end && (p = (const char *)memchr(p, '\n', c->end - p)) != NULL; p++)
+    {
+        c->num_lines++;
+    }
+    if (c->end > c->begin && c->end[-1] != '\n')
+    {
+        c->num_lines++;
+    }
+
+    return NULL;
+}
+
+/* Parses the edge lines of one chunk, mapping ids to indices with the read only id table */
+static void *_parallel_readWorker(void *arg)
+{
+    _ParallelChunk *c = (_ParallelChunk *)arg;
+    const char *line, *nl, *p;
+    long orig, dest;
+    double weight;
+    int orig_index, dest_index;
+
+    for (line = c->begin; line < c->end; line = nl + 1)
+    {
+        if (!(nl = (const char *)memchr(line, '\n', c->end - line)))
+        {
+            nl = c->end;
+        }
+
+        /* Blank lines are skipped, as _reader_nextLine does */
+        for (p = line; p < nl && (*p == ' ' || *p == '\t' || *p == '\r'); p++);
+        if (p == nl)
+        {
+            continue;
+        }
+
+        p = line;
+        if (!_parse_long(&p, nl, &orig) || !_parse_long(&p, nl, &dest) || !_parse_weight(&p, nl, &weight))
+        {
+            c->stopped = TRUE;
+            break;
+        }
+
+        /* Same checks as graph_newWeightedEdge */
+        orig_index = orig >= 0 ? _graph_findIndex(c->g, orig) : -1;
+        dest_index = dest >= 0 ? _graph_findIndex(c->g, dest) : -1;
+        if (orig_index == -1 || dest_index == -1 || !(weight >= 0) || (c->g->storage == GRAPH_DENSE && weight != 1.0))
+        {
+            c->failed = TRUE;
+            break;
+        }
+
+        if (weight != 1.0)
+        {
+            c->weighted = TRUE;
+        }
+        c->edges[c->num_edges].orig = orig_index;
+        c->edges[c->num_edges].dest = dest_index;
+        c->edges[c->num_edges].weight = weight;
+        c->num_edges++;
+    }
+
+    return NULL;
+}
+
+/**
+ * Runs worker on every chunk. The calling thread takes the last chunk,
+ * and any chunk whose thread could not be created; without memory for
+ * the threads, it takes all of them.
+ */
+static void _parallel_runChunks(_ParallelChunk *chunks, int n_chunks, void *(*worker)(void *))
+{
+    pthread_t *threads;
+    Bool *started;
+    int i;
+
+    threads = (pthread_t *)malloc(n_chunks * sizeof(pthread_t));
+    started = (Bool *)calloc(n_chunks, sizeof(Bool));
+
+    for (i = 0; threads && started && i < n_chunks - 1; i++)
+    {
+        started[i] = pthread_create(&threads[i], NULL, worker, &chunks[i]) == 0 ? TRUE : FALSE;
+    }
+    worker(&chunks[n_chunks - 1]);
+    for (i = 0; i < n_chunks - 1; i++)
+    {
+        if (started && started[i])
+        {
+            pthread_join(threads[i], NULL);
+        }
+        else
+        {
+            worker(&chunks[i]);
+        }
+    }
+
+    free(threads);
+    free(started);
+}
+
+/**
+ * Body of every BFS thread. Each level starts and ends at the barrier;
+ * between the end of a level and the start of the next one, the thread
+ * that gets PTHREAD_BARRIER_SERIAL_THREAD swaps the frontiers.
+ */
+static void *_parallel_bfsWorker(void *arg)
+{
+    _ParallelBfs *p = (_ParallelBfs *)arg;
+    int local[PAR_LOCAL];
+    int n_local, start, end, i, v, u, *swap;
+    unsigned long mask;
+    _NeighborIter it;
+
+    /* Held by the caller until the barrier is sized to the threads it got */
+    pthread_mutex_lock(&p->start);
+    pthread_mutex_unlock(&p->start);
+    if (p->done)
+    {
+        return NULL;
+    }
+
+    while (TRUE)
+    {
+        pthread_barrier_wait(&p->barrier);
+        if (p->done)
+        {
+            break;
+        }
+
+        n_local = 0;
+        while ((start = __sync_fetch_and_add(&p->cursor, PAR_CHUNK)) < p->frontier_size)
+        {
+            end = start + PAR_CHUNK < p->frontier_size ? start + PAR_CHUNK : p->frontier_size;
+            for (i = start; i < end; i++)
+            {
+                v = p->frontier[i];
+                _graph_iterStart(p->g, v, &it);
+                while ((u = _graph_iterNext(&it)) != -1)
+                {
+                    mask = 1UL << (u % BITS_PER_WORD);
+
+                    /* Cheap check first, the atomic OR decides which thread claims u */
+                    if ((p->visited[u / BITS_PER_WORD] & mask) == 0
+                        && (__sync_fetch_and_or(&p->visited[u / BITS_PER_WORD], mask) & mask) == 0)
+                    {
+                        p->dist[u] = p->depth + 1;
+                        local[n_local++] = u;
+                        if (n_local == PAR_LOCAL)
+                        {
+                            _parallel_bfsFlush(p, local, n_local);
+                            n_local = 0;
+                        }
+                    }
+                }
+            }
+        }
+        _parallel_bfsFlush(p, local, n_local);
+
+        if (pthread_barrier_wait(&p->barrier) == PTHREAD_BARRIER_SERIAL_THREAD)
+        {
+            swap = p->frontier;
+            p->frontier = p->next;
+            p->next = swap;
+            p->frontier_size = p->next_size;
+            p->next_size = 0;
+            p->cursor = 0;
+            p->depth++;
+            p->done = p->frontier_size == 0 ? TRUE : FALSE;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Answers up to BITS_PER_WORD queries with one breath search. Bit i of
+ * the words of a vertex belongs to the search that starts at from[i]:
+ * seen holds the searches that already reached the vertex, visit the
+ * ones that reached it in the current level and next the ones that reach
+ * it in the following one. The three arrays have one word per vertex and
+ * must come zeroed.
+ */
+static void _graph_msbfsBatch(const Graph *g, const int *from, const int *to, int n, int *dist, unsigned long *seen, unsigned long *visit, unsigned long *next)
+{
+    unsigned long pending = 0, found, *swap;
+    int i, v, u, depth;
+    Bool active;
+    _NeighborIter it;
+
+    for (i = 0; i < n; i++)
+    {
+        if (from[i] == to[i])
+        {
+            dist[i] = 0;
+            continue;
+        }
+
+        dist[i] = -1;
+        pending |= 1UL << i;
+        seen[from[i]] |= 1UL << i;
+        visit[from[i]] |= 1UL << i;
+    }
+
+    for (depth = 1, active = TRUE; pending != 0 && active; depth++)
+    {
+        active = FALSE;
+        for (v = 0; v < g->num_vertices; v++)
+        {
+            if (visit[v] == 0)
+            {
+                continue;
+            }
+
+            _graph_iterStart(g, v, &it);
+            while ((u = _graph_iterNext(&it)) != -1)
+            {
+                found = visit[v] & ~seen[u];
+                if (found != 0)
+                {
+                    next[u] |= found;
+                    seen[u] |= found;
+                }
+            }
+            visit[v] = 0;
+        }
+
+        /* A query is answered once its bit reaches its destination */
+        for (i = 0; i < n; i++)
+        {
+            if ((pending >> i) & 1UL && (next[to[i]] >> i) & 1UL)
+            {
+                dist[i] = depth;
+                pending &= ~(1UL << i);
+            }
+        }
+
+        for (v = 0; v < g->num_vertices && !active; v++)
+        {
+            if (next[v] != 0)
+            {
+                active = TRUE;
+            }
+        }
+
+        swap = visit;
+        visit = next;
+        next = swap;
+    }
+
+    for (v = 0; v < g->num_vertices; v++)
+    {
+        seen[v] = visit[v] = next[v] = 0;
+    }
+}
+
+/* Fletcher style sum over machine words, cheap enough to check on every load */
+static unsigned long _snapshot_checksum(const unsigned long *words, size_t n_words)
+{
+    unsigned long a = 1, b = 0;
+    size_t i;
+
+    for (i = 0; i < n_words; i++)
+    {
+        a += words[i];
+        b += a;
+    }
+
+    return b * 31 + a;
+}
+
+/* Checks that the header describes a snapshot this build can map */
+static Bool _snapshot_isValid(const _SnapshotHeader *h, size_t file_size)
+{
+    if (memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(h->magic)) != 0 || h->version != SNAPSHOT_VERSION)
+    {
+        return FALSE;
+    }
+
+    /* Bounds keep the section sizes below from wrapping and the counts within an int */
+    if (h->label_size != sizeof(Label) || h->num_vertices > MAX_VTX || h->pool_size > INT_MAX || h->total_size != file_size
+        || h->num_edges > INT_MAX || h->hash_capacity > 2UL * MAX_VTX)
+    {
+        return FALSE;
+    }
+
+    if ((h->hash_capacity & (h->hash_capacity - 1)) != 0 || h->hash_capacity < 2 * h->num_vertices
+        || (h->num_weights != 0 && h->num_weights != h->num_edges))
+    {
+        return FALSE;
+    }
+
+    if (h->ids_at != sizeof(_SnapshotHeader)
+        || h->states_at != h->ids_at + SNAPSHOT_ALIGN(h->num_vertices * sizeof(long))
+        || h->tag_at_at != h->states_at + SNAPSHOT_ALIGN(h->num_vertices * sizeof(Label))
+        || h->pool_at != h->tag_at_at + SNAPSHOT_ALIGN(h->num_vertices * sizeof(int))
+        || h->offsets_at != h->pool_at + SNAPSHOT_ALIGN(h->pool_size)
+        || h->neighbors_at != h->offsets_at + SNAPSHOT_ALIGN((h->num_vertices + 1) * sizeof(int))
+        || h->weights_at != h->neighbors_at + SNAPSHOT_ALIGN(h->num_edges * sizeof(int))
+        || h->hash_ids_at != h->weights_at + SNAPSHOT_ALIGN(h->num_weights * sizeof(double))
+        || h->hash_slots_at != h->hash_ids_at + SNAPSHOT_ALIGN(h->hash_capacity * sizeof(long))
+        || h->total_size != h->hash_slots_at + SNAPSHOT_ALIGN(h->hash_capacity * sizeof(int)))
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Makes sure no index in the snapshot points outside of its arrays, that
+ * the CSR rows are sorted without repeats, as _graph_build leaves them,
+ * and that the id table finds every vertex. A lookup in the table only
+ * ends at an empty slot, so one must exist.
+ */
+static Bool _snapshot_hasValidContents(const _SnapshotHeader *h, const char *snapshot)
+{
+    const long *ids = (const long *)(snapshot + h->ids_at);
+    const Label *states = (const Label *)(snapshot + h->states_at);
+    const int *tag_at = (const int *)(snapshot + h->tag_at_at);
+    const char *pool = snapshot + h->pool_at;
+    const int *offsets = (const int *)(snapshot + h->offsets_at);
+    const int *neighbors = (const int *)(snapshot + h->neighbors_at);
+    const double *weights = (const double *)(snapshot + h->weights_at);
+    const long *hash_ids = (const long *)(snapshot + h->hash_ids_at);
+    const int *hash_slots = (const int *)(snapshot + h->hash_slots_at);
+    unsigned long i, k, tag_len, used, mask, pos;
+
+    if (offsets[0] != 0 || offsets[h->num_vertices] != (int)h->num_edges)
+    {
+        return FALSE;
+    }
+
+    for (i = 0; i < h->num_vertices; i++)
+    {
+        if (offsets[i] > offsets[i + 1] || ids[i] < 0 || tag_at[i] < 0 || (unsigned long)tag_at[i] >= h->pool_size
+            || (states[i] != WHITE && states[i] != BLACK && states[i] != ERROR_VERTEX))
+        {
+            return FALSE;
+        }
+
+        /* Every tag must end in '\0' and fit in a Vertex */
+        tag_len = h->pool_size - tag_at[i] < TAG_LENGTH ? h->pool_size - tag_at[i] : TAG_LENGTH;
+        if (memchr(pool + tag_at[i], '\0', tag_len) == NULL)
+        {
+            return FALSE;
+        }
+    }
+
+    for (i = 0; i < h->num_vertices; i++)
+    {
+        for (k = offsets[i]; k < (unsigned long)offsets[i + 1]; k++)
+        {
+            if (neighbors[k] < 0 || neighbors[k] >= (int)h->num_vertices
+                || (k > (unsigned long)offsets[i] && neighbors[k] <= neighbors[k - 1])
+                || (h->num_weights > 0 && !(weights[k] >= 0)))
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    for (i = 0, used = 0; i < h->hash_capacity; i++)
+    {
+        if (hash_slots[i] < -1 || hash_slots[i] >= (int)h->num_vertices)
+        {
+            return FALSE;
+        }
+        if (hash_slots[i] != -1)
+        {
+            if (hash_ids[i] != ids[hash_slots[i]])
+            {
+                return FALSE;
+            }
+            used++;
+        }
+    }
+
+    if (h->num_vertices > 0 && used >= h->hash_capacity)
+    {
+        return FALSE;
+    }
+
+    /* The lookup of every id must end at its own vertex */
+    mask = h->hash_capacity - 1;
+    for (i = 0; i < h->num_vertices; i++)
+    {
+        for (pos = _id_hash(ids[i]) & mask; hash_slots[pos] != -1 && hash_ids[pos] != ids[i]; pos = (pos + 1) & mask);
+        if (hash_slots[pos] != (int)i)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static int _graph_findIndex(const Graph *g, long id)
+{
+    unsigned long mask, pos;
+
+    if (g->hash_capacity == 0)
+    {
+        return -1;
+    }
+
+    mask = (unsigned long)g->hash_capacity - 1;
+    for (pos = _id_hash(id) & mask; g->hash_slots[pos] != -1; pos = (pos + 1) & mask)
+    {
+        if (g->hash_ids[pos] == id)
+        {
+            return g->hash_slots[pos];
+        }
+    }
+
+    return -1;
+}
+
+static unsigned long _id_hash(long id)
+{
+    unsigned long h = (unsigned long)id * 2654435761UL;
+
+    return h ^ (h >> 16);
+}
+
+static Status _graph_hashResize(Graph *g, int new_capacity)
+{
+    long *ids = NULL;
+    int *slots = NULL;
+    unsigned long mask, pos;
+    int i;
+
+    ids = (long *)malloc(new_capacity * sizeof(long));
+    slots = (int *)malloc(new_capacity * sizeof(int));
+    if (!ids || !slots)
+    {
+        free(ids);
+        free(slots);
+        return ERROR;
+    }
+
+    for (i = 0; i < new_capacity; i++)
+    {
+        slots[i] = -1;
+    }
+
+    /* Reinsert every vertex already stored in the graph */
+    mask = (unsigned long)new_capacity - 1;
+    for (i = 0; i < g->num_vertices; i++)
+    {
+        pos = _id_hash(g->ids[i]) & mask;
+        while (slots[pos] != -1)
+        {
+            pos = (pos + 1) & mask;
+        }
+        ids[pos] = g->ids[i];
+        slots[pos] = i;
+    }
+
+    free(g->hash_ids);
+    free(g->hash_slots);
+    g->hash_ids = ids;
+    g->hash_slots = slots;
+    g->hash_capacity = new_capacity;
+
+    return OK;
+}
+
+/**
+ * Adds the id of a vertex that is about to be stored at position index.
+ * The table is resized before it gets more than half full.
+ */
+static Status _graph_hashInsert(Graph *g, long id, int index)
+{
+    unsigned long mask, pos;
+    int new_capacity;
+
+    if (2 * (g->num_vertices + 1) > g->hash_capacity)
+    {
+        new_capacity = g->hash_capacity > 0 ? 2 * g->hash_capacity : HASH_INIT_CAPACITY;
+        if (_graph_hashResize(g, new_capacity) == ERROR)
+        {
+            return ERROR;
+        }
+    }
+
+    mask = (unsigned long)g->hash_capacity - 1;
+    pos = _id_hash(id) & mask;
+    while (g->hash_slots[pos] != -1)
+    {
+        pos = (pos + 1) & mask;
+    }
+    g->hash_ids[pos] = id;
+    g->hash_slots[pos] = index;
+
+    return OK;
+}
+
+/* FNV-1a */
+static unsigned long _tag_hash(const char *tag)
+{
+    unsigned long h = 2166136261UL;
+
+    for (; *tag != '\0'; tag++)
+    {
+        h = (h ^ (unsigned char)*tag) * 16777619UL;
+    }
+
+    return h ^ (h >> 16);
+}
+
+/* Returns the index of the first vertex with that tag, -1 if there is none */
+static int _graph_findTag(const Graph *g, const char *tag)
+{
+    unsigned long mask, pos;
+
+    if (g->tag_capacity == 0)
+    {
+        return -1;
+    }
+
+    mask = (unsigned long)g->tag_capacity - 1;
+    for (pos = _tag_hash(tag) & mask; g->tag_slots[pos] != -1; pos = (pos + 1) & mask)
+    {
+        if (strcmp(g->tag_pool + g->tag_at[g->tag_slots[pos]], tag) == 0)
+        {
+            return g->tag_slots[pos];
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Makes sure one more tag fits in the tag table, doubling it before it
+ * gets more than half full. Once this succeeds _graph_tagInsert cannot fail.
+ */
+static Status _graph_tagReserve(Graph *g)
+{
+    int *slots = NULL;
+    unsigned long mask, pos;
+    int new_capacity, i;
+
+    if (2 * (g->num_tags + 1) <= g->tag_capacity)
+    {
+        return OK;
+    }
+
+    new_capacity = g->tag_capacity > 0 ? 2 * g->tag_capacity : HASH_INIT_CAPACITY;
+    if (!(slots = (int *)malloc(new_capacity * sizeof(int))))
+    {
+        return ERROR;
+    }
+
+    for (i = 0; i < new_capacity; i++)
+    {
+        slots[i] = -1;
+    }
+
+    mask = (unsigned long)new_capacity - 1;
+    for (i = 0; i < g->tag_capacity; i++)
+    {
+        if (g->tag_slots[i] == -1)
+        {
+            continue;
+        }
+        pos = _tag_hash(g->tag_pool + g->tag_at[g->tag_slots[i]]) & mask;
+        while (slots[pos] != -1)
+        {
+            pos = (pos + 1) & mask;
+        }
+        slots[pos] = g->tag_slots[i];
+    }
+
+    free(g->tag_slots);
+    g->tag_slots = slots;
+    g->tag_capacity = new_capacity;
+
+    return OK;
+}
+
+/* Adds the tag of vertex index, which must not be in the table yet */
+static void _graph_tagInsert(Graph *g, int index)
+{
+    unsigned long mask, pos;
+
+    mask = (unsigned long)g->tag_capacity - 1;
+    pos = _tag_hash(g->tag_pool + g->tag_at[index]) & mask;
+    while (g->tag_slots[pos] != -1)
+    {
+        pos = (pos + 1) & mask;
+    }
+    g->tag_slots[pos] = index;
+    g->num_tags++;
+}
+
+/**
+ * Constant time sanity check used on every call. Unlike is_invalid_graph
+ * it does not walk the vertices, which would make loading quadratic.
+ */
+static Bool _graph_isBroken(const Graph *g)
+{
+    if (g == NULL || g->num_vertices < 0 || g->num_vertices > MAX_VTX || g->num_edges < 0)
+    {
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * Starts a new search on s in O(1): the marks of the previous searches
+ * have older epochs and 0 is never an epoch. They are only cleared when
+ * the epoch counter wraps around.
+ */
+static void _search_start(GraphSearch *s)
+{
+    if (++s->epoch == 0)
+    {
+        memset(s->marks, 0, s->capacity * sizeof(unsigned int));
+        s->epoch = 1;
+    }
+}
+
+/* Sets every label to WHITE, undoing only the previous search when that is enough */
+static void _graph_resetSearchLabels(Graph *g)
+{
+    int i;
+
+    _graph_pullLabels(g);
+
+    if (!g->search_labels)
+    {
+        for (i = 0; i < g->num_vertices; i++)
+        {
+            _graph_setLabel(g, i, WHITE);
+        }
+    }
+    else if (g->search != NULL)
+    {
+        for (i = 0; i < g->search->num_marked; i++)
+        {
+            _graph_setLabel(g, g->search->order[i], WHITE);
+        }
+    }
+
+    if (g->search != NULL)
+    {
+        g->search->num_marked = 0;
+    }
+    g->search_labels = TRUE;
+}
+
+/**
+ * Runs one of the index based searches and prints the visited vertices
+ * the way graph_depthSearch and graph_breathSearch always have: every
+ * vertex reached by the search ends up BLACK and the rest WHITE. The
+ * graph keeps one workspace for them, and the labels the previous search
+ * set are the only ones reset, so a search costs nothing per vertex it
+ * does not reach.
+ */
+static Status _graph_printSearch(Graph *g, long from_id, long to_id, _search_kernel search)
+{
+    GraphSearch *s = NULL;
+    char data[OUTBUF_BLOCK];
+    OutBuf ob;
+    int from, n_visited = 0, i;
+
+    if (_graph_isBroken(g) || from_id < 0 || to_id < 0)
+    {
+        return ERROR;
+    }
+
+    _graph_resetSearchLabels(g);
+
+    /* The workspace only has to grow with the graph */
+    if (g->search == NULL || g->search->capacity < g->num_vertices)
+    {
+        graph_search_free(g->search);
+        if (!(g->search = graph_search_init(g)))
+        {
+            return ERROR;
+        }
+    }
+    s = g->search;
+
+    printf("From vertex ID: %ld\n", from_id);
+    printf("To vertex id: %ld\n", to_id);
+
+    from = _graph_findIndex(g, from_id);
+    if (from != -1)
+    {
+        if ((n_visited = search(g, s, from, _graph_findIndex(g, to_id))) < 0)
+        {
+            s->num_marked = 0;
+            return ERROR;
+        }
+    }
+
+    for (i = 0; i < s->num_marked; i++)
+    {
+        _graph_setLabel(g, s->order[i], BLACK);
+    }
+
+    outbuf_init(&ob, stdout, data, sizeof(data));
+    for (i = 0; i < n_visited; i++)
+    {
+        _graph_writeVertex(&ob, g, s->order[i]);
+        outbuf_putChar(&ob, '\n');
+    }
+    outbuf_flush(&ob);
+
+    return OK;
+}
+
+/*----------------------------------------------------------------------------------------*/
+Graph * graph_init()
+{
+    return graph_initWithStorage(GRAPH_SPARSE);
+}
+
+/*----------------------------------------------------------------------------------------*/
+Graph * graph_initWithStorage(GraphStorage storage)
+{
+    Graph *g = NULL;
+
+    if (storage != GRAPH_SPARSE && storage != GRAPH_DENSE)
+    {
+        return NULL;
+    }
+
+    if (!(g = (Graph *)malloc(sizeof(Graph))))
+    {
+        return NULL;
+    }
+
+    g->ids = NULL;
+    g->states = NULL;
+    g->tag_at = NULL;
+    g->vertex_capacity = 0;
+    g->tag_pool = NULL;
+    g->pool_size = 0;
+    g->pool_capacity = 0;
+    g->handles = NULL;
+    g->handle_ptrs = NULL;
+    g->num_handles = 0;
+    g->handle_capacity = 0;
+    g->handle_arena = NULL;
+    g->scratch = NULL;
+    g->num_edges = 0;
+    g->num_vertices = 0;
+    g->storage = storage;
+    g->bits = NULL;
+    g->row_words = 0;
+    g->offsets = NULL;
+    g->neighbors = NULL;
+    g->weights = NULL;
+    g->weighted = FALSE;
+    g->rev_offsets = NULL;
+    g->rev_neighbors = NULL;
+    g->rbits = NULL;
+    g->csr_vertices = 0;
+    g->pending = NULL;
+    g->num_pending = 0;
+    g->pending_capacity = 0;
+    g->hash_ids = NULL;
+    g->hash_slots = NULL;
+    g->hash_capacity = 0;
+    g->tag_slots = NULL;
+    g->tag_capacity = 0;
+    g->num_tags = 0;
+    g->search = NULL;
+    g->search_labels = TRUE;
+    g->mapping = NULL;
+    g->mapping_size = 0;
+
+    if (pthread_mutex_init(&g->lazy_lock, NULL) != 0)
+    {
+        free(g);
+        return NULL;
+    }
+
+    return g;
+}
+
+/*----------------------------------------------------------------------------------------*/
+void graph_free(Graph *g)
+{
+    if (g != NULL && g->mapping != NULL)
+    {
+        /* Everything but the graph, its reverse edges, the tag table and the handles lives in the snapshot */
+        munmap(g->mapping, g->mapping_size);
+        free(g->tag_slots);
+        free(g->rev_offsets);
+        free(g->rev_neighbors);
+        free(g->handles);
+        free(g->handle_ptrs);
+        vertex_arena_free(g->handle_arena);
+        graph_search_free(g->search);
+        pthread_mutex_destroy(&g->lazy_lock);
+        free(g);
+    }
+    else if (g != NULL)
+    {
+        free(g->ids);
+        free(g->states);
+        free(g->tag_at);
+        free(g->tag_pool);
+        free(g->handles);
+        free(g->handle_ptrs);
+        vertex_arena_free(g->handle_arena);
+        vertex_arena_free(g->scratch);
+        free(g->bits);
+        free(g->rbits);
+        free(g->rev_offsets);
+        free(g->rev_neighbors);
+        free(g->offsets);
+        free(g->neighbors);
+        free(g->weights);
+        free(g->pending);
+        free(g->hash_ids);
+        free(g->hash_slots);
+        free(g->tag_slots);
+        graph_search_free(g->search);
+        pthread_mutex_destroy(&g->lazy_lock);
+        free(g);
+    }
+}
+
+/*----------------------------------------------------------------------------------------*/
+Status graph_newVertex(Graph *g, char *desc)
+{
+    Vertex *v = NULL;
+    Status st;
+
+    if (_graph_isBroken(g) || desc == NULL || g->num_vertices == MAX_VTX || g->mapping != NULL)
+    {
+        return ERROR;
+    }
+
+    v = vertex_arena_initFromString(_graph_scratch(g), desc);
+    st = _graph_insertVertex(g, v);
+    vertex_arena_clear(g->scratch);
+
+    return st;
+}
+
+/*----------------------------------------------------------------------------------------*/
+Status graph_newEdge(Graph *g, long orig, long dest)
+{
+    return graph_newWeightedEdge(g, orig, dest, 1.0);
+}
+
+/*----------------------------------------------------------------------------------------*/
+Status graph_newWeightedEdge(Graph *g, long orig, long dest, double weight)
+{
+    int orig_index = -1;
+    int dest_index = -1;
+    _Edge *new_pending;
+    int new_capacity;
+    
+    if (_graph_isBroken(g) || orig < 0 || dest < 0 || g->mapping != NULL || !(weight >= 0))
+    {
+        return ERROR;
+    }
+
+    /* A bit matrix has no room for weights */
+    if (g->storage == GRAPH_DENSE && weight != 1.0)
+    {
+        return ERROR;
+    }
+
+    orig_index = _graph_findIndex(g, orig);
+    dest_index = _graph_findIndex(g, dest);
+
+    if (orig_index == -1 || dest_index == -1)
+    {
+        return ERROR;
+    }
+
+    if (g->storage == GRAPH_DENSE)
+    {
+        _graph_addDenseEdge(g, orig_index, dest_index);
+        return OK;
+    }
+
+    /* Edges are buffered and merged into the CSR arrays on the next build */
+    if (g->num_pending == g->pending_capacity)
+    {
+        new_capacity = g->pending_capacity > 0 ? 2 * g->pending_capacity : PENDING_INIT_CAPACITY;
+        new_pending = (_Edge *)realloc(g->pending, new_capacity * sizeof(_Edge));
+        if (!new_pending)
+        {
+            return ERROR;
+        }
+        g->pending = new_pending;
+        g->pending_capacity = new_capacity;
+    }
+
+    g->pending[g->num_pending].orig = orig_index;
+    g->pending[g->num_pending].dest = dest_index;
+    g->pending[g->num_pending].weight = weight;
+    g->num_pending++;
+
+    if (weight != 1.0)
+    {
+        g->weighted = TRUE;
+    }
+
+    return OK;
+}
+
+/*----------------------------------------------------------------------------------------*/
+Bool graph_contains(const Graph *g, long id)
+{
+    if (_graph_isBroken(g) || id < 0)
+    {
+        return FALSE;
+    }
+
+    return _graph_findIndex(g, id) != -1 ? TRUE : FALSE;
+}
+
+/*----------------------------------------------------------------------------------------*/
+int graph_getNumberOfVertices(const Graph *g)
+{
+    if (_graph_isBroken(g))
+    {
+        return -1;
+    }
+
+    return g->num_vertices;
+}
+
+/*----------------------------------------------------------------------------------------*/
+int graph_getNumberOfEdges(const Graph *g)
+{
+    if (_graph_isBroken(g) || _graph_sync(g) == ERROR)
+    {
+        return -1;
+    }
+
+    return g->num_edges;
+}
+
+/*----------------------------------------------------------------------------------------*/
+Bool graph_connectionExists(const Graph *g, long orig, long dest)
+{
+    int orig_index = -1;
+    int dest_index = -1;
+    Bool found;
+    
+    if (_graph_isBroken(g) || orig < 0 || dest < 0)
+    {
+        return FALSE;
+    }
+
+    orig_index = _graph_findIndex(g, orig);
+    dest_index = _graph_findIndex(g, dest);
+
+    if (orig_index == -1 || dest_index == -1)
+    {
+        return FALSE;
+    }
+
+    if (_graph_isSynced(g))
+    {
+        return _graph_hasEdge(g, orig_index, dest_index);
+    }
+
+    if (_graph_lockLookup(g) == ERROR)
+    {
+        return FALSE;
+    }
+    found = _graph_pendingHasEdge(g, orig_index, dest_index);
+    pthread_mutex_unlock(&((Graph *)g)->lazy_lock);
+
+    return found;
+}
+
+/*----------------------------------------------------------------------------------------*/
+int graph_getNumberOfConnectionsFromId(const Graph *g, long id)
+{
+    int index = -1;
+    int degree;
+    
+    if (_graph_isBroken(g) || id < 0)
+    {
+        return -1;
+    }
+
+    index = _graph_findIndex(g, id);
+
+    if (index == -1)
+    {
+        return -1;
+    }
+
+    if (_graph_isSynced(g))
+    {
+        return _graph_degree(g, index);
+    }
+
+    if (_graph_lockLookup(g) == ERROR)
+    {
+        return -1;
+    }
+    degree = _graph_pendingDegree(g, index);
+    pthread_mutex_unlock(&((Graph *)g)->lazy_lock);
+
+    return degree;
+}
+
+/*----------------------------------------------------------------------------------------*/
+long *graph_getConnectionsFromId(const Graph *g, long id)
+{
+    long *connections = NULL;
+    int n_connections = 0;
+    int index = -1;
+    int i, next;
+    _NeighborIter it;
+
+    if (_graph_isBroken(g) || id < 0)
+    {
+        return NULL;
+    }
+
+    index = _graph_findIndex(g, id);
+
+    if (index == -1 || _graph_sync(g) == ERROR)
+    {
+        return NULL;
+    }
+
+    n_connections = _graph_degree(g, index);
+
+    if (!(connections = (long *)malloc(n_connections * sizeof(long))))
+    {
+        return NULL;
+    }
+
+    _graph_iterStart(g, index, &it);
+    for (i = 0; (next = _graph_iterNext(&it)) != -1; i++)
+    {
+        connections[i] = g->ids[next];
+    }
+
+    return connections;
+}
+
+/*----------------------------------------------------------------------------------------*/
+int graph_getNumberOfConnectionsFromTag(const Graph *g, char *tag)
+{
+    int i;
+    
+    if (_graph_isBroken(g) || tag == NULL)
+    {
+        return -1;
+    }
+
+    if ((i = _graph_findTag(g, tag)) == -1)
+    {
+        return -1;
+    }
+
+    return graph_getNumberOfConnectionsFromId(g, g->ids[i]);
+} 
+
+/*----------------------------------------------------------------------------------------*/
+long *graph_getConnectionsFromTag(const Graph *g, char *tag)
+{
+    int i;
+    
+    if (_graph_isBroken(g) || tag == NULL)
+    {
+        return NULL;
+    }
+
+    if ((i = _graph_findTag(g, tag)) == -1)
+    {
+        return NULL;
+    }
+
+    return graph_getConnectionsFromId(g, g->ids[i]);
+}
+
+/*----------------------------------------------------------------------------------------*/
+int graph_print (FILE *pf, const Graph *g)
+{
+    char data[OUTBUF_BLOCK];
+    OutBuf ob;
+    int i, j;
+    _NeighborIter it;
+
+    if (_graph_isBroken(g) || pf == NULL || _graph_sync(g) == ERROR)
+    {
+        return -1;
+    }
+    _graph_pullLabels(g);
+
+    /* Formatted by hand into one buffer, written in OUTBUF_BLOCK pieces */
+    outbuf_init(&ob, pf, data, sizeof(data));
+    for (i = 0; i < g->num_vertices; i++)
+    {
+        _graph_writeVertex(&ob, g, i);
+        outbuf_putChars(&ob, ": ", 2);
+        _graph_iterStart(g, i, &it);
+        while ((j = _graph_iterNext(&it)) != -1)
+        {
+            _graph_writeVertex(&ob, g, j);
+        }
+
+        outbuf_putChar(&ob, '\n');
+    }
+
+    return (int)outbuf_flush(&ob);
+} 
+
+/*----------------------------------------------------------------------------------------*/
+Status graph_readFromFile (FILE *fin, Graph *g)
+{
+    _LineReader reader;
+    const char *line, *p;
+    size_t line_len;
+    long orig, dest;
+    double weight;
+    Status st;
+
+    if (_graph_isBroken(g) || fin == NULL || g->mapping != NULL)
+    {
+        return ERROR;
+    }
+
+    if (_reader_init(&reader, fin) == ERROR)
+    {
+        return ERROR;
+    }
+
+    st = _graph_readVertices(g, &reader);
+
+    /* Edges are read until the first line that is not a pair of ids and an optional weight */
+    while (st == OK && (line = _reader_nextLine(&reader, &line_len)) != NULL)
+    {
+        p = line;
+        if (!_parse_long(&p, line + line_len, &orig) || !_parse_long(&p, line + line_len, &dest)
+            || !_parse_weight(&p, line + line_len, &weight))
+        {
+            break;
+        }
+
+        st = graph_newWeightedEdge(g, orig, dest, weight);
+    }
+
+    if (reader.failed)
+    {
+        st = ERROR;
+    }
+
+    free(reader.buf);
+
+    return st == OK ? _graph_sync(g) : ERROR;
+}
+
+/* Reads the number of vertices and the vertex lines that follow it */
+static Status _graph_readVertices(Graph *g, _LineReader *r)
+{
+    const char *line;
+    size_t line_len;
+    long num_vertices = 0;
+    Vertex *v;
+    Status st = OK;
+    int i;
+
+    line = _reader_nextLine(r, &line_len);
+    if (!line || !_parse_long(&line, line + line_len, &num_vertices) || num_vertices < 1)
+    {
+        return ERROR;
+    }
 
-#define MAX_VTX 4096
+    for (i = 0; i < num_vertices && st == OK; i++)
+    {
+        if (!(line = _reader_nextLine(r, &line_len)))
+        {
+            st = ERROR;
+        }
+        else
+        {
+            v = vertex_arena_initFromBuffer(_graph_scratch(g), line, line_len);
+            st = _graph_insertVertex(g, v);
+            vertex_arena_clear(g->scratch);
+        }
+    }
 
-struct _Graph
-{
-    Vertex *vertices[MAX_VTX];
-    Bool connections[MAX_VTX][MAX_VTX];
-    int num_vertices;
-    int num_edges;
-};  
+    return st;
+}
 
 /*----------------------------------------------------------------------------------------*/
-Graph * graph_init()
+Status graph_parallelReadFromFile(FILE *fin, Graph *g, int n_threads)
 {
-    Graph *g = NULL;
-    int x, y, i;
+    _LineReader reader;
+    _ParallelChunk *chunks = NULL;
+    char *mapping = NULL;
+    const char *data, *cut;
+    size_t size, mapping_size = 0;
+    _Edge *edges, *new_pending;
+    long bound;
+    Bool weighted = FALSE;
+    int n_chunks, used, total, i, k;
+    Status st;
+
+    if (_graph_isBroken(g) || fin == NULL || g->mapping != NULL || n_threads < 1)
+    {
+        return ERROR;
+    }
 
-    if (!(g = (Graph *)malloc(sizeof(Graph))))
+    if (_reader_init(&reader, fin) == ERROR)
     {
-        return NULL;
+        return ERROR;
     }
 
-    g->num_edges = 0;
-    g->num_vertices = 0;
+    /* Vertices go through the id table one by one, edges are read in
+     * parallel straight from the mapped file, or from the buffer if it can not be mapped */
+    if (_graph_readVertices(g, &reader) == ERROR || reader.failed
+        || (!(data = _reader_map(&reader, &size, &mapping, &mapping_size)) && !(data = _reader_rest(&reader, &size))))
+    {
+        free(reader.buf);
+        return ERROR;
+    }
 
-    for (x = 0; x < MAX_VTX; x++)
+    n_chunks = size / PAR_MIN_CHUNK < (size_t)n_threads ? (int)(size / PAR_MIN_CHUNK) + 1 : n_threads;
+    if (!(chunks = (_ParallelChunk *)calloc(n_chunks, sizeof(_ParallelChunk))))
     {
-        for (y = 0; y < MAX_VTX; y++)
+        if (mapping)
         {
-            g->connections[x][y] = FALSE;
-        }  
+            munmap(mapping, mapping_size);
+        }
+        free(reader.buf);
+        return ERROR;
     }
 
-    for (i = 0; i < MAX_VTX; i++)
+    /* Every chunk but the first starts right after a line break */
+    for (i = 0, cut = data; i < n_chunks; i++)
     {
-        g->vertices[i] = NULL;
+        chunks[i].g = g;
+        chunks[i].begin = cut;
+        cut = i == n_chunks - 1 ? data + size : data + size / n_chunks * (i + 1);
+        if (cut < chunks[i].begin)
+        {
+            cut = chunks[i].begin;
+        }
+        while (cut < data + size && cut > data && cut[-1] != '\n')
+        {
+            cut++;
+        }
+        chunks[i].end = cut;
     }
-    
-    
-    return g;
+
+    _parallel_runChunks(chunks, n_chunks, _parallel_countWorker);
+    for (i = 0, bound = 0; i < n_chunks; i++)
+    {
+        bound += chunks[i].num_lines;
+    }
+
+    /* Sparse graphs take the edges in the pending buffer, merged into the
+     * CSR arrays by the next build. Dense graphs only need them for their bits */
+    st = OK;
+    edges = NULL;
+    if (bound > INT_MAX - g->num_pending)
+    {
+        st = ERROR;
+    }
+    else if (g->storage == GRAPH_DENSE)
+    {
+        if (!(edges = (_Edge *)malloc((bound > 0 ? bound : 1) * sizeof(_Edge))))
+        {
+            st = ERROR;
+        }
+    }
+    else
+    {
+        if (g->num_pending + bound > g->pending_capacity)
+        {
+            if (!(new_pending = (_Edge *)realloc(g->pending, (g->num_pending + bound) * sizeof(_Edge))))
+            {
+                st = ERROR;
+            }
+            else
+            {
+                g->pending = new_pending;
+                g->pending_capacity = g->num_pending + bound;
+            }
+        }
+        edges = g->pending + g->num_pending;
+    }
+
+    if (st == OK)
+    {
+        for (i = 0, k = 0; i < n_chunks; i++)
+        {
+            chunks[i].edges = edges + k;
+            k += chunks[i].num_lines;
+        }
+        _parallel_runChunks(chunks, n_chunks, _parallel_readWorker);
+    }
+
+    /* Chunks are taken in file order until the first line that ends the
+     * edges. Blank lines leave gaps after a chunk, later chunks are moved down over them */
+    for (used = 0, total = 0; used < n_chunks && st == OK; used++)
+    {
+        if (chunks[used].edges != edges + total)
+        {
+            memmove(edges + total, chunks[used].edges, chunks[used].num_edges * sizeof(_Edge));
+        }
+        total += chunks[used].num_edges;
+        if (chunks[used].weighted)
+        {
+            weighted = TRUE;
+        }
+        if (chunks[used].failed)
+        {
+            st = ERROR;
+        }
+        if (chunks[used].stopped)
+        {
+            break;
+        }
+    }
+
+    if (st == OK && g->storage == GRAPH_DENSE)
+    {
+        for (k = 0; k < total; k++)
+        {
+            _graph_addDenseEdge(g, edges[k].orig, edges[k].dest);
+        }
+    }
+    else if (st == OK)
+    {
+        g->num_pending += total;
+        if (weighted)
+        {
+            g->weighted = TRUE;
+        }
+    }
+
+    if (g->storage == GRAPH_DENSE)
+    {
+        free(edges);
+    }
+    free(chunks);
+    if (mapping)
+    {
+        munmap(mapping, mapping_size);
+    }
+    free(reader.buf);
+
+    return st == OK ? _graph_sync(g) : ERROR;
 }
 
 /*----------------------------------------------------------------------------------------*/
-void graph_free(Graph *g)
+Bool is_invalid_graph (const Graph *g)
 {
+    Vertex view;
     int i;
+    
+    if (g == NULL)
+    {
+        return TRUE;
+    }
+
+    if (g->num_vertices < 0 || g->num_vertices > MAX_VTX)
+    {
+        return TRUE;
+    }
 
-    if (g != NULL)
+    if (g->num_edges < 0 || g->num_edges > (double)g->num_vertices * g->num_vertices)
     {
-        for (i = 0; i < g->num_vertices; i++) 
+        return TRUE;
+    }
+
+    _graph_pullLabels(g);
+    for (i = 0; i < g->num_vertices; i++)
+    {
+        _graph_vertexView(g, i, &view);
+        if (is_invalid_vertex(&view))
         {
-            vertex_free(g->vertices[i]);
+            return TRUE;
         }
-        free(g);
     }
+    
+    return FALSE;
 }
 
 /*----------------------------------------------------------------------------------------*/
-Status graph_newVertex(Graph *g, char *desc)
+Status graph_set_all_vertex_label(Graph *g, Label l)
 {
-    Vertex *v;
+    int i;
 
-    if (is_invalid_graph(g) || desc == NULL || g->num_vertices == MAX_VTX)
+    if (_graph_isBroken(g) || (l != WHITE && l != BLACK && l != ERROR_VERTEX))
     {
         return ERROR;
     }
 
-    v = vertex_initFromString(desc);
+    _graph_pullLabels(g);
 
-    if (v == NULL)
+    /* Nothing is changed if some vertex is not valid */
+    for (i = 0; i < g->num_vertices; i++)
     {
-        return ERROR;
+        if (g->states[i] == ERROR_VERTEX)
+        {
+            return ERROR;
+        }
     }
 
-    else if (is_invalid_vertex(v))
-    {
-        vertex_free(v);
-        return ERROR;
-    }
-    
-    if (graph_contains(g, vertex_getId(v)))
+    for (i = 0; i < g->num_vertices; i++)
     {
-        vertex_free(v);
-        return OK;
+        _graph_setLabel(g, i, l);
     }
-    
-    g->vertices[g->num_vertices] = v;
-    vertex_set_index(v, g->num_vertices);
-    g->num_vertices++;
+    g->search_labels = FALSE;
 
     return OK;
 }
 
 /*----------------------------------------------------------------------------------------*/
-Status graph_newEdge(Graph *g, long orig, long dest)
+Vertex **graph_get_vertex_array(Graph *g)
 {
-    int orig_index = -1;
-    int dest_index = -1;
-    int i;
-    
-    if (is_invalid_graph(g) || orig < 0 || dest < 0)
+    Vertex **handles;
+    Vertex **handle_ptrs;
+    int capacity, i;
+
+    if (_graph_isBroken(g))
     {
-        return ERROR;
+        return NULL;
     }
 
-    for (i = 0; i < g->num_vertices; i++)
+    _graph_pullLabels(g);
+
+    /* Only the arrays of pointers move, the records stay where they are */
+    if (g->num_vertices > g->handle_capacity)
     {
-        if (g->vertices[i]->id == orig)
+        for (capacity = g->handle_capacity > 0 ? g->handle_capacity : 64; capacity < g->num_vertices; capacity *= 2);
+
+        if (!(handles = (Vertex **)realloc(g->handles, capacity * sizeof(Vertex *))))
         {
-            orig_index = i;
+            return NULL;
         }
-        if (g->vertices[i]->id == dest)
+        g->handles = handles;
+
+        if (!(handle_ptrs = (Vertex **)realloc(g->handle_ptrs, capacity * sizeof(Vertex *))))
         {
-            dest_index = i;
+            return NULL;
         }
+        g->handle_ptrs = handle_ptrs;
+        g->handle_capacity = capacity;
     }
 
-    if (orig_index == -1 || dest_index == -1)
+    if (g->handle_arena == NULL && !(g->handle_arena = vertex_arena_init()))
     {
-        return ERROR;
+        return NULL;
     }
 
-    if (graph_connectionExists(g, orig_index, dest_index))
+    for (; g->num_handles < g->num_vertices; g->num_handles++)
     {
-        return OK;
+        if (!(g->handles[g->num_handles] = vertex_arena_new(g->handle_arena)))
+        {
+            return NULL;
+        }
     }
-    
-    g->connections[orig_index][dest_index] = TRUE;
-    g->num_edges++;
 
-    return OK;
+    /* Ids and tags changed through the records are not taken, they are restored here */
+    for (i = 0; i < g->num_vertices; i++)
+    {
+        _graph_vertexView(g, i, g->handles[i]);
+        g->handle_ptrs[i] = g->handles[i];
+    }
+
+    return g->handle_ptrs;
 }
 
 /*----------------------------------------------------------------------------------------*/
-Bool graph_contains(const Graph *g, long id)
+int graph_getVertexIndex(const Graph *g, long id)
 {
-    int i;
-    
-    if (is_invalid_graph(g) || id < 0)
+    if (_graph_isBroken(g) || id < 0)
     {
-        return FALSE;
+        return -1;
     }
 
-    for (i = 0; i < g->num_vertices; i++)
+    return _graph_findIndex(g, id);
+}
+
+/*----------------------------------------------------------------------------------------*/
+GraphSearch *graph_search_init(const Graph *g)
+{
+    GraphSearch *s = NULL;
+    int capacity;
+
+    if (_graph_isBroken(g))
     {
-        if (g->vertices[i]->id == id)
-        {
-            return TRUE;
-        }        
+        return NULL;
     }
 
-    return FALSE;
+    if (!(s = (GraphSearch *)malloc(sizeof(GraphSearch))))
+    {
+        return NULL;
+    }
+
+    capacity = g->num_vertices > 0 ? g->num_vertices : 1;
+    s->marks = (unsigned int *)calloc(capacity, sizeof(unsigned int));
+    s->epoch = 1;
+    s->frontier = (int *)malloc(capacity * sizeof(int));
+    s->order = (int *)malloc(capacity * sizeof(int));
+    s->parent = (int *)malloc(capacity * sizeof(int));
+    s->frontier_bits = (unsigned long *)malloc(BITSET_WORDS(capacity) * sizeof(unsigned long));
+    s->capacity = capacity;
+    s->num_marked = 0;
+
+    if (!s->marks || !s->frontier || !s->order || !s->parent || !s->frontier_bits)
+    {
+        graph_search_free(s);
+        return NULL;
+    }
+
+    return s;
 }
 
 /*----------------------------------------------------------------------------------------*/
-int graph_getNumberOfVertices(const Graph *g)
+void graph_search_free(GraphSearch *s)
 {
-    if (is_invalid_graph(g))
+    if (s != NULL)
     {
-        return -1;
+        free(s->marks);
+        free(s->frontier);
+        free(s->order);
+        free(s->parent);
+        free(s->frontier_bits);
+        free(s);
     }
-
-    return g->num_vertices;
 }
 
 /*----------------------------------------------------------------------------------------*/
-int graph_getNumberOfEdges(const Graph *g)
+const int *graph_search_getOrder(const GraphSearch *s)
 {
-    if (is_invalid_graph(g))
+    if (s == NULL)
     {
-        return -1;
+        return NULL;
     }
 
-    return g->num_edges;
+    return s->order;
 }
 
 /*----------------------------------------------------------------------------------------*/
-Bool graph_connectionExists(const Graph *g, long orig, long dest)
+int graph_depthSearchIndex(const Graph *g, GraphSearch *s, int from, int to)
 {
-    int orig_index = -1;
-    int dest_index = -1;
-    int i;
-    
-    if (is_invalid_graph(g) || orig < 0 || dest < 0)
+    int top = 0;
+    int visited = 0;
+    int current, next;
+    _NeighborIter it;
+
+    if (_graph_isBroken(g) || s == NULL || from < 0 || from >= g->num_vertices || s->capacity < g->num_vertices)
     {
-        return FALSE;
+        return -1;
     }
 
-    for (i = 0; i < g->num_vertices; i++)
+    if (_graph_sync(g) == ERROR)
+    {
+        return -1;
+    }
+
+    _search_start(s);
+
+    /* Vertices are marked when pushed, so the stack never holds more than V entries */
+    SEARCH_VISIT(s, from);
+    s->parent[from] = -1;
+    s->frontier[top++] = from;
+
+    while (top > 0)
     {
-        if (g->vertices[i]->id == orig)
+        current = s->frontier[--top];
+        s->order[visited++] = current;
+
+        if (current == to)
         {
-            orig_index = i;
+            break;
         }
-        if (g->vertices[i]->id == dest)
+
+        _graph_iterStart(g, current, &it);
+        while ((next = _graph_iterNext(&it)) != -1)
         {
-            dest_index = i;
+            if (!SEARCH_VISITED(s, next))
+            {
+                SEARCH_VISIT(s, next);
+                s->parent[next] = current;
+                s->frontier[top++] = next;
+            }
         }
     }
 
-    if (orig_index == -1 || dest_index == -1)
+    /* Marked vertices still in the stack go after the visited ones */
+    memcpy(s->order + visited, s->frontier, top * sizeof(int));
+    s->num_marked = visited + top;
+
+    return visited;
+}
+
+/*----------------------------------------------------------------------------------------*/
+int graph_breathSearchIndex(const Graph *g, GraphSearch *s, int from, int to)
+{
+    int head = 0;
+    int tail = 0;
+    int current, next;
+    _NeighborIter it;
+
+    if (_graph_isBroken(g) || s == NULL || from < 0 || from >= g->num_vertices || s->capacity < g->num_vertices)
     {
-        return FALSE;
+        return -1;
+    }
+
+    if (_graph_sync(g) == ERROR)
+    {
+        return -1;
+    }
+
+    _search_start(s);
+
+    /* The order array doubles as the queue: vertices leave it in the order they entered */
+    SEARCH_VISIT(s, from);
+    s->parent[from] = -1;
+    s->order[tail++] = from;
+
+    while (head < tail)
+    {
+        current = s->order[head++];
+
+        if (current == to)
+        {
+            break;
+        }
+
+        _graph_iterStart(g, current, &it);
+        while ((next = _graph_iterNext(&it)) != -1)
+        {
+            if (!SEARCH_VISITED(s, next))
+            {
+                SEARCH_VISIT(s, next);
+                s->parent[next] = current;
+                s->order[tail++] = next;
+            }
+        }
     }
 
-    return g->connections[orig_index][dest_index];
+    s->num_marked = tail;
+
+    return head;
 }
 
 /*----------------------------------------------------------------------------------------*/
-int graph_getNumberOfConnectionsFromId(const Graph *g, long id)
+int graph_breathSearchLevels(const Graph *g, GraphSearch *s, int from, int *level, GraphBfsMode mode)
 {
-    int counter = 0;
-    int index = -1;
-    int i;
-    
-    if (is_invalid_graph(g) || id < 0)
+    int head = 0;
+    int tail = 0;
+    int depth = 0;
+    long edges_frontier, edges_unexplored;
+    Bool bottom_up = FALSE;
+    int level_end, current, next, i;
+    _NeighborIter it;
+
+    if (_graph_isBroken(g) || s == NULL || level == NULL || from < 0 || from >= g->num_vertices || s->capacity < g->num_vertices)
+    {
+        return -1;
+    }
+
+    if ((mode != GRAPH_BFS_TOP_DOWN && mode != GRAPH_BFS_DIRECTION_OPTIMIZING) || _graph_sync(g) == ERROR)
+    {
+        return -1;
+    }
+
+    if (mode == GRAPH_BFS_DIRECTION_OPTIMIZING && _graph_syncReverse(g) == ERROR)
     {
         return -1;
     }
 
+    _search_start(s);
     for (i = 0; i < g->num_vertices; i++)
     {
-        if (g->vertices[i]->id == id)
+        level[i] = -1;
+    }
+
+    SEARCH_VISIT(s, from);
+    s->parent[from] = -1;
+    level[from] = 0;
+    s->order[tail++] = from;
+
+    edges_frontier = _graph_degree(g, from);
+    edges_unexplored = g->num_edges - edges_frontier;
+
+    /* Every level is the slice [head, level_end) of the order array */
+    while (head < tail)
+    {
+        level_end = tail;
+        depth++;
+
+        if (mode == GRAPH_BFS_DIRECTION_OPTIMIZING)
+        {
+            if (!bottom_up && edges_frontier > edges_unexplored / BFS_ALPHA)
+            {
+                bottom_up = TRUE;
+            }
+            else if (bottom_up && level_end - head < g->num_vertices / BFS_BETA)
+            {
+                bottom_up = FALSE;
+            }
+        }
+
+        if (bottom_up)
+        {
+            /* Every unvisited vertex looks for a parent in the frontier */
+            memset(s->frontier_bits, 0, BITSET_WORDS(g->num_vertices) * sizeof(unsigned long));
+            for (i = head; i < level_end; i++)
+            {
+                BITSET_SET(s->frontier_bits, s->order[i]);
+            }
+
+            for (next = 0; next < g->num_vertices; next++)
+            {
+                if (!SEARCH_VISITED(s, next) && (current = _graph_parentInFrontier(g, next, s->frontier_bits)) != -1)
+                {
+                    SEARCH_VISIT(s, next);
+                    s->parent[next] = current;
+                    level[next] = depth;
+                    s->order[tail++] = next;
+                }
+            }
+        }
+        else
         {
-            index = i;
-            break;
+            /* Every frontier vertex pushes its unvisited neighbors */
+            for (i = head; i < level_end; i++)
+            {
+                current = s->order[i];
+                _graph_iterStart(g, current, &it);
+                while ((next = _graph_iterNext(&it)) != -1)
+                {
+                    if (!SEARCH_VISITED(s, next))
+                    {
+                        SEARCH_VISIT(s, next);
+                        s->parent[next] = current;
+                        level[next] = depth;
+                        s->order[tail++] = next;
+                    }
+                }
+            }
         }
-    }
-
-    if (index == -1)
-    {
-        return -1;
-    }
 
-    for (i = 0; i < MAX_VTX; i++)
-    {
-        if (g->connections[index][i] == TRUE)
+        edges_frontier = 0;
+        for (i = level_end; i < tail; i++)
         {
-            counter++;
+            edges_frontier += _graph_degree(g, s->order[i]);
         }
+        edges_unexplored -= edges_frontier;
+        head = level_end;
     }
-    
-    return counter;
+
+    return tail;
 }
 
 /*----------------------------------------------------------------------------------------*/
-long *graph_getConnectionsFromId(const Graph *g, long id)
+int graph_parallelBreathSearch(const Graph *g, long from_id, int *dist, int n_threads)
 {
-    long *connections = NULL;
-    int n_connections = 0;
-    int counter = 0;
-    int index = -1;
-    int i;
-
-    if (is_invalid_graph(g) || id < 0)
-    {
-        return NULL;
-    }
+    _ParallelBfs p;
+    pthread_t *threads = NULL;
+    int from, started, i, reached;
 
-    for (i = 0; i < g->num_vertices; i++)
+    if (_graph_isBroken(g) || from_id < 0 || dist == NULL || n_threads < 1)
     {
-        if (g->vertices[i]->id == id)
-        {
-            index = i;
-            break;
-        }
+        return -1;
     }
 
-    if (index == -1)
+    if ((from = _graph_findIndex(g, from_id)) == -1 || _graph_sync(g) == ERROR)
     {
-        return NULL;
+        return -1;
     }
 
-    n_connections = graph_getNumberOfConnectionsFromId(g, id);
-
-    if (n_connections == -1)
+    p.g = g;
+    p.dist = dist;
+    p.visited = (volatile unsigned long *)calloc(BITSET_WORDS(g->num_vertices), sizeof(unsigned long));
+    p.frontier = (int *)malloc(g->num_vertices * sizeof(int));
+    p.next = (int *)malloc(g->num_vertices * sizeof(int));
+    threads = (pthread_t *)malloc(n_threads * sizeof(pthread_t));
+    if (!p.visited || !p.frontier || !p.next || !threads || pthread_mutex_init(&p.start, NULL) != 0)
     {
-        return NULL;
+        free((void *)p.visited);
+        free(p.frontier);
+        free(p.next);
+        free(threads);
+        return -1;
     }
 
-    if (!(connections = (long *)malloc(n_connections * sizeof(long))))
+    for (i = 0; i < g->num_vertices; i++)
     {
-        return NULL;
+        dist[i] = -1;
     }
 
-    for (i = 0; i < MAX_VTX; i++)
+    p.visited[from / BITS_PER_WORD] |= 1UL << (from % BITS_PER_WORD);
+    dist[from] = 0;
+    p.frontier[0] = from;
+    p.frontier_size = 1;
+    p.next_size = 0;
+    p.cursor = 0;
+    p.depth = 0;
+    p.done = FALSE;
+
+    /* The calling thread works too, as the last of the n_threads. If some
+     * thread cannot be created the search runs with the ones that were */
+    pthread_mutex_lock(&p.start);
+    for (started = 0; started < n_threads - 1; started++)
     {
-        if (g->connections[index][i] == TRUE)
+        if (pthread_create(&threads[started], NULL, _parallel_bfsWorker, &p) != 0)
         {
-            connections[counter] = g->vertices[i]->id;
-            counter++;
+            break;
         }
     }
 
-    return connections;
-}
-
-/*----------------------------------------------------------------------------------------*/
-int graph_getNumberOfConnectionsFromTag(const Graph *g, char *tag)
-{
-    int i;
-    
-    if (is_invalid_graph(g) || tag == NULL)
-    {
-        return -1;
-    }
-
-    for (i = 0; i < g->num_vertices; i++)
+    if (pthread_barrier_init(&p.barrier, NULL, started + 1) != 0)
     {
-        if (strcmp(g->vertices[i]->tag, tag) == 0)
+        /* Nobody has reached the barrier yet: workers see done and leave */
+        p.done = TRUE;
+        pthread_mutex_unlock(&p.start);
+        for (i = 0; i < started; i++)
         {
-            return graph_getNumberOfConnectionsFromId(g, g->vertices[i]->id);
+            pthread_join(threads[i], NULL);
         }
+        reached = -1;
     }
-
-    return -1;
-} 
-
-/*----------------------------------------------------------------------------------------*/
-long *graph_getConnectionsFromTag(const Graph *g, char *tag)
-{
-    int i;
-    
-    if (is_invalid_graph(g) || tag == NULL)
+    else
     {
-        return NULL;
-    }
+        pthread_mutex_unlock(&p.start);
+        _parallel_bfsWorker(&p);
+        for (i = 0; i < started; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+        pthread_barrier_destroy(&p.barrier);
 
-    for (i = 0; i < g->num_vertices; i++)
-    {
-        if (strcmp(g->vertices[i]->tag, tag) == 0)
+        for (i = 0, reached = 0; i < g->num_vertices; i++)
         {
-            return graph_getConnectionsFromId(g, g->vertices[i]->id);
+            if (dist[i] != -1)
+            {
+                reached++;
+            }
         }
     }
 
-    return NULL;
+    pthread_mutex_destroy(&p.start);
+    free((void *)p.visited);
+    free(p.frontier);
+    free(p.next);
+    free(threads);
+
+    return reached;
 }
 
 /*----------------------------------------------------------------------------------------*/
-int graph_print (FILE *pf, const Graph *g)
+Status graph_batchDistances(const Graph *g, const long *from_ids, const long *to_ids, int n_queries, int *dist)
 {
-    int character_counter = 0;
-    int i, j;
+    unsigned long *seen = NULL, *visit = NULL, *next = NULL;
+    int from[BITS_PER_WORD], to[BITS_PER_WORD];
+    int start, n, i;
 
-    if (is_invalid_graph(g) || pf == NULL)
+    if (_graph_isBroken(g) || !from_ids || !to_ids || !dist || n_queries < 0)
     {
-        return -1;
+        return ERROR;
     }
 
-    for (i = 0; i < g->num_vertices; i++)
+    for (i = 0; i < n_queries; i++)
     {
-        character_counter += vertex_print(pf, g->vertices[i]);
-        character_counter += fprintf(pf, ": ");
-        for (j = 0; j < MAX_VTX; j++)
+        if (_graph_findIndex(g, from_ids[i]) == -1 || _graph_findIndex(g, to_ids[i]) == -1)
         {
-            if (g->connections[i][j] == TRUE)
-            {
-                character_counter += vertex_print(pf, g->vertices[j]);
-            }
+            return ERROR;
         }
-
-        character_counter += fprintf(pf, "\n");
     }
 
-    return character_counter;
-} 
-
-/*----------------------------------------------------------------------------------------*/
-Status graph_readFromFile (FILE *fin, Graph *g)
-{
-    int num_vertices = 0;
-    char temp[MAX_DATA];
-    int temp_id_orig = 0;
-    int temp_id_dest = 0;
-    int i;
-
-    if (is_invalid_graph(g) || fin == NULL)
+    if (n_queries == 0)
     {
-        return ERROR;
+        return OK;
     }
 
-    fscanf(fin, "%d\n", &num_vertices);
-    if (num_vertices < 1)
+    if (_graph_sync(g) == ERROR)
     {
         return ERROR;
     }
 
-    for (i = 0; i < num_vertices; i++)
+    seen = (unsigned long *)calloc(g->num_vertices, sizeof(unsigned long));
+    visit = (unsigned long *)calloc(g->num_vertices, sizeof(unsigned long));
+    next = (unsigned long *)calloc(g->num_vertices, sizeof(unsigned long));
+    if (!seen || !visit || !next)
     {
-        if (fgets(temp, MAX_DATA, fin) == NULL)
-        {
-            return ERROR;
-        }
-        
-        if (graph_newVertex(g, temp) == ERROR)
-        {
-            return ERROR;
-        }
-
-        if (vertex_set_index(g->vertices[i], i) == ERROR)
-        {
-            return ERROR;
-        }
-        
+        free(seen);
+        free(visit);
+        free(next);
+        return ERROR;
     }
 
-    while (fscanf(fin, "%d %d\n", &temp_id_orig, &temp_id_dest) == 2)
+    for (start = 0; start < n_queries; start += n)
     {
-        if (graph_newEdge(g, temp_id_orig, temp_id_dest) == ERROR)
+        n = n_queries - start < BITS_PER_WORD ? n_queries - start : BITS_PER_WORD;
+        for (i = 0; i < n; i++)
         {
-            return ERROR;
+            from[i] = _graph_findIndex(g, from_ids[start + i]);
+            to[i] = _graph_findIndex(g, to_ids[start + i]);
         }
+        _graph_msbfsBatch(g, from, to, n, dist + start, seen, visit, next);
     }
 
+    free(seen);
+    free(visit);
+    free(next);
+
     return OK;
 }
 
 /*----------------------------------------------------------------------------------------*/
-Bool is_invalid_graph (const Graph *g)
+long *graph_shortestPath(const Graph *g, GraphSearch *s, long from_id, long to_id, int *length)
 {
-    int i;
-    
-    if (g == NULL)
+    long *path = NULL;
+    int from, to, v, n;
+
+    if (length == NULL)
     {
-        return TRUE;
+        return NULL;
     }
+    *length = 0;
 
-    if (g->num_vertices < 0 || g->num_vertices > MAX_VTX)
+    if (_graph_isBroken(g) || from_id < 0 || to_id < 0)
     {
-        return TRUE;
+        return NULL;
     }
 
-    if (g->num_edges < 0 || g->num_edges > MAX_VTX * MAX_VTX)
+    from = _graph_findIndex(g, from_id);
+    to = _graph_findIndex(g, to_id);
+    if (from == -1 || to == -1)
     {
-        return TRUE;
+        return NULL;
     }
 
-    for (i = 0; i < g->num_vertices; i++)
+    /* BFS reaches every vertex through a path with the fewest edges */
+    if (graph_breathSearchIndex(g, s, from, to) < 0 || !SEARCH_VISITED(s, to))
+    {
+        return NULL;
+    }
+
+    for (n = 1, v = to; v != from; v = s->parent[v])
+    {
+        n++;
+    }
+
+    if ((path = (long *)malloc(n * sizeof(long))) != NULL)
     {
-        if (g->vertices[i] == NULL || vertex_get_index(g->vertices[i]) != i || is_invalid_vertex(g->vertices[i]))
+        *length = n;
+        for (v = to; n > 0; v = s->parent[v])
         {
-            return TRUE;
+            path[--n] = g->ids[v];
         }
     }
-    
-    return FALSE;
+
+    return path;
 }
 
 /*----------------------------------------------------------------------------------------*/
-Status graph_set_all_vertex_label(Graph *g, Label l)
+Status graph_dijkstra(const Graph *g, long from_id, double *dist, int *parent)
 {
-    int i;
-    Label *backup = NULL;
+    _IndexHeap h;
+    _NeighborIter it;
+    int from, u, v, i;
+    double d;
 
+    if (_graph_isBroken(g) || from_id < 0 || dist == NULL)
+    {
+        return ERROR;
+    }
 
-    if (is_invalid_graph(g) || (l != WHITE && l != BLACK && l != ERROR_VERTEX))
+    if ((from = _graph_findIndex(g, from_id)) == -1 || _graph_sync(g) == ERROR)
     {
         return ERROR;
     }
-    
-    /*Create backup in case something fails*/
-    backup = (Label *)malloc(g->num_vertices * sizeof(Label));
-    if (!backup) 
+
+    h.heap = (int *)malloc(g->num_vertices * sizeof(int));
+    h.pos = (int *)malloc(g->num_vertices * sizeof(int));
+    h.key = dist;
+    h.size = 0;
+    if (!h.heap || !h.pos)
     {
-         return ERROR;
+        free(h.heap);
+        free(h.pos);
+        return ERROR;
     }
 
     for (i = 0; i < g->num_vertices; i++)
     {
-        backup[i] = vertex_getState(g->vertices[i]);
-        if (backup[i] == ERROR_VERTEX)
+        dist[i] = HUGE_VAL;
+        h.pos[i] = -1;
+        if (parent)
         {
-            free(backup);
-            return ERROR;
+            parent[i] = -1;
         }
     }
 
-    for (i = 0; i < g->num_vertices; i++)
+    dist[from] = 0;
+    _heap_update(&h, from);
+
+    while (h.size > 0)
     {
-        if (vertex_setState(g->vertices[i], l) == ERROR)
+        u = _heap_pop(&h);
+
+        _graph_iterStart(g, u, &it);
+        while ((v = _graph_iterNext(&it)) != -1)
         {
-            for (; i >= 0; i--)
+            d = dist[u] + _graph_iterWeight(&it);
+            if (d < dist[v])
             {
-                vertex_setState(g->vertices[i], backup[i]);
+                dist[v] = d;
+                if (parent)
+                {
+                    parent[v] = u;
+                }
+                _heap_update(&h, v);
             }
-            free(backup);
-            return ERROR;
         }
     }
-    
-    free(backup);
+
+    free(h.heap);
+    free(h.pos);
+
     return OK;
 }
 
 /*----------------------------------------------------------------------------------------*/
-Vertex **graph_get_vertex_array(Graph *g)
+Status graph_depthSearch(Graph *g, long from_id, long to_id)
 {
-    if (is_invalid_graph(g))
-    {
-        return NULL;
-    }
-
-    return g->vertices;
+    return _graph_printSearch(g, from_id, to_id, graph_depthSearchIndex);
 }
 
 /*----------------------------------------------------------------------------------------*/
-Status graph_depthSearch(Graph *g, long from_id, long to_id)
+Status graph_breathSearch (Graph *g, long from_id, long to_id)
 {
-    int i, j, num_vertices;
-    Stack *st = NULL;
-    Vertex **vertex_array = NULL;
-    Vertex *current = NULL;
-    Vertex *neighbor = NULL;
-    long *connections = NULL;
-    int n_connections = 0;
+    return _graph_printSearch(g, from_id, to_id, graph_breathSearchIndex);
+}
 
-    if (is_invalid_graph(g) || from_id < 0 || to_id < 0)
+/*----------------------------------------------------------------------------------------*/
+Status graph_saveBinary(const Graph *g, const char *path)
+{
+    _SnapshotHeader h;
+    _NeighborIter it;
+    char *snapshot = NULL;
+    int *offsets, *neighbors, *hash_slots;
+    double *weights;
+    long *hash_ids;
+    FILE *f = NULL;
+    int i, next;
+    size_t written;
+
+    if (_graph_isBroken(g) || path == NULL || _graph_sync(g) == ERROR)
     {
         return ERROR;
     }
-
-    /*Set all vertices to white*/
-    if (graph_set_all_vertex_label(g, WHITE) == ERROR)
-    {
-        printf("Could not perform algorithm (Code 001)");
-    }
-
-    /*Execute algorithm*/
-    if (!(st = stack_init()))
+    _graph_pullLabels(g);
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.label_size = sizeof(Label);
+    h.num_vertices = g->num_vertices;
+    h.num_edges = g->num_edges;
+    h.num_weights = g->weights != NULL ? g->num_edges : 0;
+    h.hash_capacity = g->hash_capacity;
+    h.pool_size = g->pool_size;
+    h.ids_at = sizeof(_SnapshotHeader);
+    h.states_at = h.ids_at + SNAPSHOT_ALIGN(h.num_vertices * sizeof(long));
+    h.tag_at_at = h.states_at + SNAPSHOT_ALIGN(h.num_vertices * sizeof(Label));
+    h.pool_at = h.tag_at_at + SNAPSHOT_ALIGN(h.num_vertices * sizeof(int));
+    h.offsets_at = h.pool_at + SNAPSHOT_ALIGN(h.pool_size);
+    h.neighbors_at = h.offsets_at + SNAPSHOT_ALIGN((h.num_vertices + 1) * sizeof(int));
+    h.weights_at = h.neighbors_at + SNAPSHOT_ALIGN(h.num_edges * sizeof(int));
+    h.hash_ids_at = h.weights_at + SNAPSHOT_ALIGN(h.num_weights * sizeof(double));
+    h.hash_slots_at = h.hash_ids_at + SNAPSHOT_ALIGN(h.hash_capacity * sizeof(long));
+    h.total_size = h.hash_slots_at + SNAPSHOT_ALIGN(h.hash_capacity * sizeof(int));
+
+    /* The whole snapshot is laid out in memory first, zeroing the padding */
+    if (!(snapshot = (char *)calloc(h.total_size, 1)))
     {
         return ERROR;
     }
 
-    if ((num_vertices = graph_getNumberOfVertices(g)) < 0)
-    {
-        stack_free(st);
-        printf("Could not perform algorithm (Code 002)");
-        return ERROR;
-    }
+    offsets = (int *)(snapshot + h.offsets_at);
+    neighbors = (int *)(snapshot + h.neighbors_at);
+    weights = (double *)(snapshot + h.weights_at);
+    hash_ids = (long *)(snapshot + h.hash_ids_at);
+    hash_slots = (int *)(snapshot + h.hash_slots_at);
 
-    if (!(vertex_array = graph_get_vertex_array(g)))
+    if (g->num_vertices > 0)
     {
-        stack_free(st);
-        printf("Could not perform algorithm (Code 003)");
-        return ERROR;
+        memcpy(snapshot + h.ids_at, g->ids, g->num_vertices * sizeof(long));
+        memcpy(snapshot + h.states_at, g->states, g->num_vertices * sizeof(Label));
+        memcpy(snapshot + h.tag_at_at, g->tag_at, g->num_vertices * sizeof(int));
+        memcpy(snapshot + h.pool_at, g->tag_pool, g->pool_size);
     }
 
-    /*Find "from" vertex, paint black and add to stack*/
-    for (i = 0; i < num_vertices; i++) {
-        if (vertex_getId(vertex_array[i]) == from_id) {
-            vertex_setState(vertex_array[i], BLACK);
-            stack_push(st, vertex_array[i]);
-            break;
-        }
-    }
-
-    /*Main loop for algorithm*/
-    printf("From vertex ID: %ld\n", from_id);
-    printf("To vertex id: %ld\n", to_id);
-
-    while (!stack_isEmpty(st))
+    /* Dense graphs are stored as CSR too, rows come out sorted either way */
+    offsets[0] = 0;
+    for (i = 0; i < g->num_vertices; i++)
     {
-        current = stack_pop(st);
-        vertex_print(stdout, current);
-        printf("\n");
-
-        /* Check if we found target */
-        if (vertex_getId(current) == to_id)
+        offsets[i + 1] = offsets[i];
+        _graph_iterStart(g, i, &it);
+        while ((next = _graph_iterNext(&it)) != -1)
         {
-            stack_free(st);
-            return OK;
+            if (h.num_weights > 0)
+            {
+                weights[offsets[i + 1]] = _graph_iterWeight(&it);
+            }
+            neighbors[offsets[i + 1]++] = next;
         }
+    }
 
-        /* Get connections for current vertex */
-        n_connections = graph_getNumberOfConnectionsFromId(g, vertex_getId(current));
-        if (n_connections < 0)
-        {
-            stack_free(st);
-            return ERROR;
-        }
+    if (g->hash_capacity > 0)
+    {
+        memcpy(hash_ids, g->hash_ids, g->hash_capacity * sizeof(long));
+        memcpy(hash_slots, g->hash_slots, g->hash_capacity * sizeof(int));
+    }
 
-        connections = graph_getConnectionsFromId(g, vertex_getId(current));
-        if (!connections && n_connections > 0)
-        {
-            stack_free(st);
-            return ERROR;
-        }
+    h.checksum = _snapshot_checksum((const unsigned long *)(snapshot + sizeof(_SnapshotHeader)), (h.total_size - sizeof(_SnapshotHeader)) / sizeof(unsigned long));
+    memcpy(snapshot, &h, sizeof(h));
 
-        /* Add unvisited neighbors to stack */
-        for (j = 0; j < n_connections; j++)
-        {
-            /* Find neighbor vertex object from its ID */
-            for (i = 0; i < num_vertices; i++)
-            {
-                if (vertex_getId(vertex_array[i]) == connections[j])
-                {
-                    neighbor = vertex_array[i];
-                    break;
-                }
-            }
+    if (!(f = fopen(path, "wb")))
+    {
+        free(snapshot);
+        return ERROR;
+    }
 
-            /* If neighbor is unvisited, mark it and add to stack */
-            if (vertex_getState(neighbor) == WHITE)
-            {
-                vertex_setState(neighbor, BLACK);
-                if (stack_push(st, neighbor) == ERROR)
-                {
-                    stack_free(st);
-                    free(connections);
-                    return ERROR;
-                }
-            }
-        }
+    written = fwrite(snapshot, 1, h.total_size, f);
+    free(snapshot);
 
-        if (connections)
-        {
-            free(connections);
-        }
+    if (fclose(f) != 0 || written != h.total_size)
+    {
+        return ERROR;
     }
 
-    stack_free(st);
-
     return OK;
 }
 
 /*----------------------------------------------------------------------------------------*/
-Status graph_breathSearch (Graph *g, long from_id, long to_id)
+Graph *graph_loadBinary(const char *path)
 {
-    int i, j, num_vertices;
-    Queue *qu = NULL;
-    Vertex **vertex_array = NULL;
-    Vertex *current = NULL;
-    Vertex *neighbor = NULL;
-    long *connections = NULL;
-    int n_connections = 0;
+    struct stat st;
+    const _SnapshotHeader *h;
+    char *mapping;
+    Graph *g = NULL;
+    int fd, i;
+    Bool valid;
 
-    if (is_invalid_graph(g) || from_id < 0 || to_id < 0)
+    if (path == NULL || (fd = open(path, O_RDONLY)) < 0)
     {
-        return ERROR;
+        return NULL;
     }
 
-    /*Set all vertices to white*/
-    if (graph_set_all_vertex_label(g, WHITE) == ERROR)
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(_SnapshotHeader))
     {
-        printf("Could not perform algorithm (Code 001)");
+        close(fd);
+        return NULL;
     }
 
-    /*Execute algorithm*/
-    if (!(qu = queue_new()))
+    /* Private mapping: vertex labels can still be changed, the file never is */
+    mapping = (char *)mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
     {
-        return ERROR;
+        return NULL;
     }
 
-    if ((num_vertices = graph_getNumberOfVertices(g)) < 0)
+    h = (const _SnapshotHeader *)mapping;
+    valid = _snapshot_isValid(h, st.st_size);
+    if (valid)
     {
-        queue_free(qu);
-        printf("Could not perform algorithm (Code 002)");
-        return ERROR;
+        valid = h->checksum == _snapshot_checksum((const unsigned long *)(mapping + sizeof(_SnapshotHeader)), (h->total_size - sizeof(_SnapshotHeader)) / sizeof(unsigned long)) ? TRUE : FALSE;
     }
-
-    if (!(vertex_array = graph_get_vertex_array(g)))
+    if (valid)
     {
-        queue_free(qu);
-        printf("Could not perform algorithm (Code 003)");
-        return ERROR;
+        valid = _snapshot_hasValidContents(h, mapping);
     }
 
-    /*Find "from" vertex, paint black and add to stack*/
-    for (i = 0; i < num_vertices; i++) {
-        if (vertex_getId(vertex_array[i]) == from_id) {
-            vertex_setState(vertex_array[i], BLACK);
-            queue_push(qu, vertex_array[i]);
-            break;
-        }
+    if (!valid || !(g = graph_init()))
+    {
+        munmap(mapping, st.st_size);
+        return NULL;
     }
 
-    /*Main loop for algorithm*/
-    printf("From vertex ID: %ld\n", from_id);
-    printf("To vertex id: %ld\n", to_id);
-
-    while (!queue_isEmpty(qu))
+    /* Point the graph at the snapshot sections, nothing is copied */
+    g->ids = (long *)(mapping + h->ids_at);
+    g->states = (Label *)(mapping + h->states_at);
+    g->tag_at = (int *)(mapping + h->tag_at_at);
+    g->vertex_capacity = h->num_vertices;
+    g->tag_pool = mapping + h->pool_at;
+    g->pool_size = h->pool_size;
+    g->pool_capacity = h->pool_size;
+    g->num_vertices = h->num_vertices;
+    g->num_edges = h->num_edges;
+    g->offsets = (int *)(mapping + h->offsets_at);
+    g->neighbors = (int *)(mapping + h->neighbors_at);
+    g->weights = h->num_weights > 0 ? (double *)(mapping + h->weights_at) : NULL;
+    g->weighted = h->num_weights > 0 ? TRUE : FALSE;
+    g->csr_vertices = h->num_vertices;
+    g->hash_ids = h->hash_capacity > 0 ? (long *)(mapping + h->hash_ids_at) : NULL;
+    g->hash_slots = h->hash_capacity > 0 ? (int *)(mapping + h->hash_slots_at) : NULL;
+    g->hash_capacity = h->hash_capacity;
+    g->search_labels = FALSE;
+    g->mapping = mapping;
+    g->mapping_size = st.st_size;
+
+    /* The tag table is not part of the snapshot, it is rebuilt here */
+    for (i = 0; i < g->num_vertices; i++)
     {
-        current = queue_pop(qu);
-        vertex_print(stdout, current);
-        printf("\n");
-
-        /* Check if we found target */
-        if (vertex_getId(current) == to_id)
-        {
-            queue_free(qu);
-            return OK;
-        }
-
-        /* Get connections for current vertex */
-        n_connections = graph_getNumberOfConnectionsFromId(g, vertex_getId(current));
-        if (n_connections < 0)
-        {
-            queue_free(qu);
-            return ERROR;
-        }
-
-        connections = graph_getConnectionsFromId(g, vertex_getId(current));
-        if (!connections && n_connections > 0)
-        {
-            queue_free(qu);
-            return ERROR;
-        }
-
-        /* Add unvisited neighbors to stack */
-        for (j = 0; j < n_connections; j++)
+        if (_graph_findTag(g, g->tag_pool + g->tag_at[i]) != -1)
         {
-            /* Find neighbor vertex object from its ID */
-            for (i = 0; i < num_vertices; i++)
-            {
-                if (vertex_getId(vertex_array[i]) == connections[j])
-                {
-                    neighbor = vertex_array[i];
-                    break;
-                }
-            }
-
-            /* If neighbor is unvisited, mark it and add to stack */
-            if (vertex_getState(neighbor) == WHITE)
-            {
-                vertex_setState(neighbor, BLACK);
-                if (queue_push(qu, neighbor) == ERROR)
-                {
-                    queue_free(qu);
-                    free(connections);
-                    return ERROR;
-                }
-            }
+            continue;
         }
-
-        if (connections)
+        if (_graph_tagReserve(g) == ERROR)
         {
-            free(connections);
+            graph_free(g);
+            return NULL;
         }
+        _graph_tagInsert(g, i);
     }
 
-    queue_free(qu);
-
-    return OK;
+    return g;
 }
-
-
-
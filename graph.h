@@ -14,6 +14,33 @@
 
 typedef struct _Graph Graph;
 
+/**
+ * @brief Storage used for the edges of a graph.
+ */
+typedef enum {
+    GRAPH_SPARSE, /*!< Compressed sparse rows, memory grows with V + E */
+    GRAPH_DENSE   /*!< Adjacency matrix packed to one bit per pair of vertices */
+} GraphStorage;
+
+/**
+ * @brief Strategy used by graph_breathSearchLevels.
+ */
+typedef enum {
+    GRAPH_BFS_TOP_DOWN,            /*!< Every level expands the edges of its vertices */
+    GRAPH_BFS_DIRECTION_OPTIMIZING /*!< Large levels are found bottom-up from the unvisited vertices */
+} GraphBfsMode;
+
+/**
+ * @brief Reusable workspace for the index based searches.
+ *
+ * Holds the visited marks, the frontier and the visit order, so a
+ * search does not allocate anything once the workspace exists. Marks
+ * are stamped with a counter that changes every search, so starting a
+ * search does not need to clear them. Several searches can run at the
+ * same time on one graph, each one with its own workspace.
+ */
+typedef struct _GraphSearch GraphSearch;
+
 /**
  * @brief Creates a new empty graph.
  * 
@@ -27,6 +54,24 @@ typedef struct _Graph Graph;
  **/
 Graph * graph_init();
 
+/**
+ * @brief Creates a new empty graph with the given edge storage.
+ * 
+ * @author Izan Robles
+ *
+ * GRAPH_SPARSE is the storage used by graph_init and suits graphs with
+ * few edges per vertex. GRAPH_DENSE keeps a bit matrix, which is smaller
+ * and faster when most pairs of vertices are connected. Either way the
+ * graph grows as vertices are added; the bit matrix doubles its side
+ * when it is full, so its memory stays quadratic in the vertices.
+ *
+ * @param storage Edge storage to be used by the graph.
+ *
+ * @return A pointer to the graph if it was correctly allocated, 
+ * NULL otherwise.
+ **/
+Graph * graph_initWithStorage(GraphStorage storage);
+
 /**
  * @brief Frees a graph.
  * 
@@ -63,6 +108,12 @@ Status graph_newVertex(Graph *g, char *desc);
  * If any of the two vertices does not exist in the graph the edge is
  * not created.
  *
+ * In a GRAPH_SPARSE graph, new edges wait in a buffer and are merged
+ * into the adjacency arrays, in O(V + E), by the first query that needs
+ * them. graph_connectionExists and graph_getNumberOfConnectionsFromId
+ * look through up to about sqrt(V + E) buffered edges instead, so adding
+ * edges and checking them in turns does not merge on every check.
+ *
  * @param g Pointer to the graph.
  * @param orig ID of the origin vertex.
  * @param dest ID of the destination vertex.
@@ -71,6 +122,25 @@ Status graph_newVertex(Graph *g, char *desc);
  **/
 Status graph_newEdge(Graph *g, long orig, long dest);
 
+/**
+ * @brief Creates a weighted edge between to vertices of a graph.
+ *
+ * @author Izan Robles
+ * 
+ * If any of the two vertices does not exist in the graph the edge is
+ * not created. Edges created with graph_newEdge weigh 1. If the same
+ * edge is added more than once, the smallest weight is kept. 
+ * GRAPH_DENSE graphs keep one bit per edge, so they only accept weight 1.
+ *
+ * @param g Pointer to the graph.
+ * @param orig ID of the origin vertex.
+ * @param dest ID of the destination vertex.
+ * @param weight Weight of the edge, it can not be negative.
+ *
+ * @return OK if the edge could be added to the graph, ERROR otherwise.
+ **/
+Status graph_newWeightedEdge(Graph *g, long orig, long dest, double weight);
+
 /**
  * @brief Checks if a graph contains a vertex.
  * 
@@ -156,6 +226,9 @@ long *graph_getConnectionsFromId(const Graph *g, long id);
  *
  * @author Izan Robles
  * 
+ * The vertex is found through a tag hash table. If several vertices
+ * share the tag, the first one added to the graph is used.
+ *
  * @param g Pointer to the graph.
  * @param tag Tag of the origin vertex.
  *
@@ -171,7 +244,8 @@ int graph_getNumberOfConnectionsFromTag(const Graph *g, char *tag);
  * @author Izan Robles
  * @author Arturo Pérez
  * 
- * This function allocates memory for the array.
+ * This function allocates memory for the array. As in
+ * graph_getNumberOfConnectionsFromTag, the first vertex with the tag is used.
  *
  * @param g Pointer to the graph.
  * @param tag Tag of the origin vertex.
@@ -216,7 +290,7 @@ int graph_print (FILE *pf, const Graph *g);
  * The first line in the file contains the number of vertices.
  * Then one line per vertex with the vertex description.  
  * Finally one line per connection, with the ids of the origin and 
- * the destination. 
+ * the destination, optionally followed by the weight of the edge. 
  *
  * For example:
  *
@@ -226,7 +300,7 @@ int graph_print (FILE *pf, const Graph *g);
  * id:3 tag:Avila
  * id:4 tag:Segovia
  * 1 2
- * 1 3
+ * 1 3 2.5
  * 2 4
  * 4 3
  *
@@ -237,6 +311,28 @@ int graph_print (FILE *pf, const Graph *g);
  */
 Status graph_readFromFile (FILE *fin, Graph *g);
 
+/**
+ * @brief Reads a graph from a file, parsing its edges with several threads.
+ *
+ * @author Izan Robles
+ *
+ * Accepts the same files as graph_readFromFile and, when it succeeds,
+ * leaves the same graph; on errors no edge from the file is added.
+ * The vertices are read first; the rest of the file is then mapped
+ * (or read at once from streams that can not be mapped), split into one
+ * chunk per thread at line breaks, and each thread parses its chunk
+ * straight into its own part of the pending edges, sized by counting the
+ * lines first. They are sorted into the adjacency arrays in a single
+ * build. Small files use fewer threads.
+ *
+ * @param fin Pointer to the input stream.
+ * @param g Pointer to the graph.
+ * @param n_threads Number of threads to use, including the calling one
+ *
+ * @return OK or ERROR
+ */
+Status graph_parallelReadFromFile(FILE *fin, Graph *g, int n_threads);
+
 /**
  * @brief Verifies if all the fields of a graph are valid.
  * 
@@ -265,9 +361,17 @@ Status graph_set_all_vertex_label(Graph *g, Label l);
  * 
  * @author Izan Robles
  *
+ * The graph keeps its vertices as arrays of ids, tags and labels, so this
+ * gives a Vertex for each of them, in index order, to be used with the
+ * vertex functions. The records belong to the graph and stay at the same
+ * address until graph_free. Labels set through them with vertex_setState
+ * are written back to the graph; ids and tags are not, and are restored
+ * by the next call. The array itself may move if vertices were added
+ * since the previous call.
+ *
  * @param g Graph pointer
  *
- * @return  Returns a pointer to the graph vertex
+ * @return  Returns a pointer to the graph vertex, or NULL if an error is found
  */
 Vertex **graph_get_vertex_array(Graph *g);
 
@@ -297,5 +401,236 @@ Status graph_depthSearch(Graph *g, long from_id, long to_id);
  */
 Status graph_breathSearch (Graph *g, long from_id, long to_id);
 
+/**
+ * @brief Gets the index of the vertex with a given id
+ *
+ * @author Izan Robles
+ *
+ * @param g Graph pointer
+ * @param id ID of the vertex
+ *
+ * @return Returns the position of the vertex in the vertex array, or
+ * -1 if there is no such vertex or an error is found.
+ */
+int graph_getVertexIndex(const Graph *g, long id);
+
+/**
+ * @brief Creates a search workspace sized for a graph
+ *
+ * @author Izan Robles
+ *
+ * The workspace can be reused by any number of searches on g as long as
+ * no vertices are added to the graph.
+ *
+ * @param g Graph pointer
+ *
+ * @return Returns the new workspace, or NULL if an error is found.
+ */
+GraphSearch *graph_search_init(const Graph *g);
+
+/**
+ * @brief Frees a search workspace
+ *
+ * @author Izan Robles
+ *
+ * @param s Workspace to be freed
+ */
+void graph_search_free(GraphSearch *s);
+
+/**
+ * @brief Gets the vertex indices visited by the last search
+ *
+ * @author Izan Robles
+ *
+ * @param s Workspace pointer
+ *
+ * @return Returns the array of visited indices, in visit order. Its
+ * length is the value returned by the search. NULL if s is NULL.
+ */
+const int *graph_search_getOrder(const GraphSearch *s);
+
+/**
+ * @brief Executes depth search algorithm over vertex indices
+ *
+ * @author Izan Robles
+ *
+ * Visits vertices in the same order as graph_depthSearch, without
+ * printing nor changing the vertex labels.
+ *
+ * @param g Graph pointer
+ * @param s Workspace created for g
+ * @param from Index of vertex to start from
+ * @param to Index of vertex to end path, or -1 to visit every reachable vertex
+ *
+ * @return Returns the number of visited vertices, or -1 if something went wrong
+ */
+int graph_depthSearchIndex(const Graph *g, GraphSearch *s, int from, int to);
+
+/**
+ * @brief Executes breath search algorithm over vertex indices
+ *
+ * @author Izan Robles
+ *
+ * Visits vertices in the same order as graph_breathSearch, without
+ * printing nor changing the vertex labels.
+ *
+ * @param g Graph pointer
+ * @param s Workspace created for g
+ * @param from Index of vertex to start from
+ * @param to Index of vertex to end path, or -1 to visit every reachable vertex
+ *
+ * @return Returns the number of visited vertices, or -1 if something went wrong
+ */
+int graph_breathSearchIndex(const Graph *g, GraphSearch *s, int from, int to);
+
+/**
+ * @brief Computes the distance in edges from a vertex to all the others
+ *
+ * @author Izan Robles
+ *
+ * Runs a level by level breath search. With GRAPH_BFS_DIRECTION_OPTIMIZING
+ * the levels that reach a large part of the graph are built bottom-up:
+ * every unvisited vertex checks whether any of its incoming edges comes
+ * from the current level, which avoids re-checking visited neighbors. This
+ * needs the incoming edges of the graph, which are built and kept by the
+ * graph the first time they are used. Both modes find the same levels.
+ *
+ * Afterwards, graph_search_getOrder returns the reached vertices sorted by
+ * level.
+ *
+ * @param g Graph pointer
+ * @param s Workspace created for g
+ * @param from Index of vertex to start from
+ * @param level Output, with room for graph_getNumberOfVertices entries.
+ * Distance of every vertex index to from, -1 if it can not be reached.
+ * @param mode Search strategy
+ *
+ * @return Returns the number of reached vertices, or -1 if something went wrong
+ */
+int graph_breathSearchLevels(const Graph *g, GraphSearch *s, int from, int *level, GraphBfsMode mode);
+
+/**
+ * @brief Computes the distance in edges from a vertex to all the others
+ * using several threads
+ *
+ * @author Izan Robles
+ *
+ * Level synchronous breath search: the threads share the vertices of the
+ * current level and build the next one together, waiting for each other
+ * at the end of every level. Gives the same distances as
+ * graph_breathSearchLevels. The graph must not be modified meanwhile.
+ *
+ * @param g Graph pointer
+ * @param from_id Id of vertex to start from
+ * @param dist Output, with room for graph_getNumberOfVertices entries.
+ * Distance of every vertex index to from_id, -1 if it can not be reached.
+ * @param n_threads Number of threads to use, including the calling one
+ *
+ * @return Returns the number of reached vertices, or -1 if something went wrong
+ */
+int graph_parallelBreathSearch(const Graph *g, long from_id, int *dist, int n_threads);
+
+/**
+ * @brief Answers many distance queries between pairs of vertices at once
+ *
+ * @author Izan Robles
+ *
+ * Query i asks for the number of edges of the shortest path from
+ * from_ids[i] to to_ids[i]. The queries are answered in groups of as many
+ * as bits has an unsigned long (64 in most machines): every vertex keeps
+ * one bit per query of the group, so a single breath search over the
+ * graph advances all of them together. Does not touch the vertex labels.
+ *
+ * @param g Graph pointer
+ * @param from_ids Ids of the vertices to start from
+ * @param to_ids Ids of the vertices to reach
+ * @param n_queries Number of queries
+ * @param dist Output, with room for n_queries entries. Distance of every
+ * query, -1 if its destination can not be reached.
+ *
+ * @return Returns OK or ERROR if some id is not in the graph or something
+ * went wrong
+ */
+Status graph_batchDistances(const Graph *g, const long *from_ids, const long *to_ids, int n_queries, int *dist);
+
+/**
+ * @brief Finds a path with the fewest edges between two vertices
+ *
+ * @author Izan Robles
+ *
+ * This function allocates memory for the path. The breath search runs in
+ * the workspace s, so many queries on the same graph reuse its buffers
+ * instead of allocating O(V) memory each; afterwards s holds that search,
+ * as after graph_breathSearchIndex.
+ *
+ * @param g Graph pointer
+ * @param s Workspace created for g
+ * @param from_id ID of the vertex the path starts at
+ * @param to_id ID of the vertex the path ends at
+ * @param length Output, number of vertices in the path (0 if there is none)
+ *
+ * @return Returns an array with the ids of the vertices of the path, from
+ * from_id to to_id both included, or NULL if to_id cannot be reached from
+ * from_id or an error is found.
+ */
+long *graph_shortestPath(const Graph *g, GraphSearch *s, long from_id, long to_id, int *length);
+
+/**
+ * @brief Computes the shortest weighted distance from a vertex to all
+ * the others (Dijkstra's algorithm).
+ *
+ * @author Izan Robles
+ *
+ * Both output arrays are indexed by vertex index (see
+ * graph_getVertexIndex) and must have room for graph_getNumberOfVertices
+ * entries. Runs in O((V + E) log V).
+ *
+ * @param g Graph pointer
+ * @param from_id ID of the source vertex
+ * @param dist Output, distance to every vertex, HUGE_VAL if it can not be reached
+ * @param parent Output, index of the previous vertex in the shortest path to
+ * every vertex, -1 for the source and unreachable vertices. Can be NULL.
+ *
+ * @return Returns OK or ERROR if something went wrong
+ */
+Status graph_dijkstra(const Graph *g, long from_id, double *dist, int *parent);
+
+/**
+ * @brief Saves a graph to a binary snapshot file
+ *
+ * @author Izan Robles
+ *
+ * The snapshot stores the vertices, the adjacency in CSR form and the id
+ * index, together with a version number and a checksum. It is written
+ * in the native layout of the machine, so it is meant to be loaded back
+ * by the same build with graph_loadBinary.
+ *
+ * @param g Graph pointer
+ * @param path Name of the file to be written
+ *
+ * @return Returns OK or ERROR if something went wrong
+ */
+Status graph_saveBinary(const Graph *g, const char *path);
+
+/**
+ * @brief Loads a graph from a binary snapshot file
+ *
+ * @author Izan Robles
+ *
+ * The file is memory mapped and the graph queries work directly on the
+ * mapped data, without copying its arrays. Loading still makes one pass
+ * over the whole file: it checks the checksum and the contents (every
+ * adjacency row, weight and id table slot), so it takes O(V + E) time,
+ * much less than reading the text file. The loaded graph is read only: new vertices or edges cannot be added, but
+ * vertex labels can still be changed. The file must not be modified
+ * while the graph is in use. Free the graph with graph_free.
+ *
+ * @param path Name of the snapshot file
+ *
+ * @return Returns the loaded graph, or NULL if the file could not be
+ * mapped or is not a valid snapshot.
+ */
+Graph *graph_loadBinary(const char *path);
+
 #endif
 
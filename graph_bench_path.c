@@ -0,0 +1,139 @@
+/**
+ * @file  graph_bench_path.c
+ * @author Izan Robles
+ * @brief Times graph_shortestPath on a graph with more than 100k vertices
+ *
+ * Builds a road-like grid of BENCH_SIDE x BENCH_SIDE vertices and asks
+ * for paths between nearby vertices, so every breath search stops after
+ * a small part of the graph. The same queries are answered twice: once
+ * with one search workspace for all of them, and once creating a new
+ * workspace for every query, which is what each query used to cost.
+ */
+
+#include <time.h>
+#include "graph.h"
+
+#define BENCH_SIDE 450L
+#define BENCH_VERTICES (BENCH_SIDE * BENCH_SIDE)
+#define BENCH_RADIUS 10L
+#define BENCH_QUERIES 20000
+
+static unsigned long bench_next(unsigned long *x);
+
+/* xorshift, so every run builds the same graph */
+static unsigned long bench_next(unsigned long *x)
+{
+    *x ^= (*x << 13) & 0xFFFFFFFFUL;
+    *x ^= *x >> 17;
+    *x ^= (*x << 5) & 0xFFFFFFFFUL;
+
+    return *x;
+}
+
+int main()
+{
+    Graph *g = NULL;
+    GraphSearch *s = NULL;
+    long from[BENCH_QUERIES], to[BENCH_QUERIES];
+    long id, row, col, *path;
+    unsigned long seed = 2463534242UL;
+    char desc[64];
+    int i, length;
+    long total_shared = 0, total_fresh = 0;
+    clock_t start;
+    double shared_time, fresh_time;
+
+    if (!(g = graph_init()))
+    {
+        printf("ERROR: could not initialize graph\n");
+        return 1;
+    }
+
+    for (id = 1; id <= BENCH_VERTICES; id++)
+    {
+        sprintf(desc, "id:%ld tag:v%ld state:0", id, id);
+        if (graph_newVertex(g, desc) == ERROR)
+        {
+            printf("ERROR: could not add vertex %ld\n", id);
+            graph_free(g);
+            return 1;
+        }
+    }
+    /* Id row * BENCH_SIDE + col + 1 is joined both ways to its right and lower neighbours */
+    for (id = 1; id <= BENCH_VERTICES; id++)
+    {
+        row = (id - 1) / BENCH_SIDE;
+        col = (id - 1) % BENCH_SIDE;
+        if (col + 1 < BENCH_SIDE)
+        {
+            graph_newEdge(g, id, id + 1);
+            graph_newEdge(g, id + 1, id);
+        }
+        if (row + 1 < BENCH_SIDE)
+        {
+            graph_newEdge(g, id, id + BENCH_SIDE);
+            graph_newEdge(g, id + BENCH_SIDE, id);
+        }
+    }
+
+    /* Destinations at most BENCH_RADIUS rows and columns away */
+    for (i = 0; i < BENCH_QUERIES; i++)
+    {
+        row = (long)(bench_next(&seed) % (BENCH_SIDE - BENCH_RADIUS));
+        col = (long)(bench_next(&seed) % (BENCH_SIDE - BENCH_RADIUS));
+        from[i] = row * BENCH_SIDE + col + 1;
+        to[i] = (row + (long)(bench_next(&seed) % BENCH_RADIUS)) * BENCH_SIDE + col + (long)(bench_next(&seed) % BENCH_RADIUS) + 1;
+    }
+    printf("--> graph with %d vertices and %d edges built\n", graph_getNumberOfVertices(g), graph_getNumberOfEdges(g));
+
+    if (!(s = graph_search_init(g)))
+    {
+        printf("ERROR: could not create the search workspace\n");
+        graph_free(g);
+        return 1;
+    }
+
+    /* The first query also builds the adjacency arrays, it is left out of the times */
+    free(graph_shortestPath(g, s, 1, 2, &length));
+
+    start = clock();
+    for (i = 0; i < BENCH_QUERIES; i++)
+    {
+        if ((path = graph_shortestPath(g, s, from[i], to[i], &length)) != NULL)
+        {
+            total_shared += length;
+            free(path);
+        }
+    }
+    shared_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    graph_search_free(s);
+
+    start = clock();
+    for (i = 0; i < BENCH_QUERIES; i++)
+    {
+        if ((s = graph_search_init(g)) != NULL)
+        {
+            if ((path = graph_shortestPath(g, s, from[i], to[i], &length)) != NULL)
+            {
+                total_fresh += length;
+                free(path);
+            }
+            graph_search_free(s);
+        }
+    }
+    fresh_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("--> %d queries, %ld path vertices in total\n", BENCH_QUERIES, total_shared);
+    printf("--> one workspace for all queries: %.3fs (%.1f us per query)\n", shared_time, 1e6 * shared_time / BENCH_QUERIES);
+    printf("--> new workspace for every query: %.3fs (%.1f us per query)\n", fresh_time, 1e6 * fresh_time / BENCH_QUERIES);
+
+    graph_free(g);
+
+    if (total_shared != total_fresh)
+    {
+        printf("ERROR: both runs should find the same paths\n");
+        return 1;
+    }
+
+    return 0;
+}
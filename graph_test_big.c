@@ -0,0 +1,117 @@
+/**
+ * @file  graph_test_big.c
+ * @author Izan Robles
+ * @brief Loads a graph of more than a million vertices and checks it
+ *
+ * The vertices are past the old limit of 4096 by far, so the vertex
+ * storage, the id table and the adjacency arrays all grow many times
+ * while the graph is read. Prints OK and returns 0 if every check passes.
+ */
+
+#include <time.h>
+#include "graph.h"
+
+#define BIG_VERTICES 1100000L
+#define BIG_JUMP 1000L
+
+static int check(int ok, const char *what);
+
+static int check(int ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("ERROR: %s\n", what);
+    }
+
+    return ok ? 0 : 1;
+}
+
+int main()
+{
+    Graph *g = NULL;
+    GraphSearch *s = NULL;
+    FILE *file = NULL;
+    long id, *path = NULL;
+    long n_jumps, expected_edges, expected_hops;
+    int length = 0, failed = 0;
+    clock_t start;
+
+    /* Ids 1..BIG_VERTICES in a chain, plus a jump of BIG_JUMP from every id that is 1 modulo BIG_JUMP */
+    if (!(file = tmpfile()))
+    {
+        printf("ERROR: could not create the graph file\n");
+        return 1;
+    }
+
+    fprintf(file, "%ld\n", BIG_VERTICES);
+    for (id = 1; id <= BIG_VERTICES; id++)
+    {
+        fprintf(file, "id:%ld tag:v%ld state:0\n", id, id);
+    }
+    for (id = 1; id < BIG_VERTICES; id++)
+    {
+        fprintf(file, "%ld %ld\n", id, id + 1);
+        if (id % BIG_JUMP == 1 && id + BIG_JUMP <= BIG_VERTICES)
+        {
+            fprintf(file, "%ld %ld\n", id, id + BIG_JUMP);
+        }
+    }
+    rewind(file);
+    printf("--> graph file with %ld vertices written\n", BIG_VERTICES);
+
+    if (!(g = graph_init()))
+    {
+        printf("ERROR: could not initialize graph\n");
+        fclose(file);
+        return 1;
+    }
+
+    start = clock();
+    if (graph_readFromFile(file, g) == ERROR)
+    {
+        printf("ERROR: could not read graph\n");
+        graph_free(g);
+        fclose(file);
+        return 1;
+    }
+    fclose(file);
+    printf("--> graph read in %.2fs\n", (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    n_jumps = (BIG_VERTICES - 1) / BIG_JUMP;
+    expected_edges = BIG_VERTICES - 1 + n_jumps;
+    expected_hops = n_jumps + (BIG_VERTICES - (1 + n_jumps * BIG_JUMP));
+
+    failed += check(graph_getNumberOfVertices(g) == BIG_VERTICES, "wrong number of vertices");
+    failed += check(graph_getNumberOfEdges(g) == expected_edges, "wrong number of edges");
+    failed += check(graph_contains(g, 1) && graph_contains(g, BIG_VERTICES), "missing vertex");
+    failed += check(!graph_contains(g, BIG_VERTICES + 1) && !graph_contains(g, 0), "unexpected vertex");
+    failed += check(graph_getVertexIndex(g, BIG_VERTICES) == BIG_VERTICES - 1, "vertices out of order");
+    failed += check(graph_connectionExists(g, BIG_VERTICES - 1, BIG_VERTICES), "missing edge");
+    failed += check(!graph_connectionExists(g, BIG_VERTICES, 1), "unexpected edge");
+    failed += check(graph_getNumberOfConnectionsFromId(g, 1) == 2, "wrong degree");
+
+    /* Adding past the end keeps working */
+    failed += check(graph_newVertex(g, "id:0 tag:extra state:0") == OK, "could not add a vertex");
+    failed += check(graph_newEdge(g, 0, 1) == OK && graph_connectionExists(g, 0, 1), "could not add an edge");
+
+    if (!(s = graph_search_init(g)))
+    {
+        printf("ERROR: could not create the search workspace\n");
+        graph_free(g);
+        return 1;
+    }
+
+    start = clock();
+    path = graph_shortestPath(g, s, 1, BIG_VERTICES, &length);
+    printf("--> shortest path found in %.2fs\n", (double)(clock() - start) / CLOCKS_PER_SEC);
+    failed += check(path != NULL && length == expected_hops + 1, "wrong shortest path length");
+    failed += check(path != NULL && path[0] == 1 && path[length - 1] == BIG_VERTICES, "wrong shortest path ends");
+    free(path);
+
+    graph_search_free(s);
+    graph_free(g);
+
+    printf(failed == 0 ? "OK\n" : "ERROR: %d checks failed\n", failed);
+
+    return failed == 0 ? 0 : 1;
+}
@@ -283,10 +283,40 @@ int list_print(FILE *fp, const List *pl, P_ele_print f)
     do
     {
         chars_printed += f(fp, node->data);
-        chars_printed += fprintf(fp, " ");
+        chars_printed += putc(' ', fp) == EOF ? 0 : 1;
         node = node->next;
     } while (node != pl->last->next);
 
     fprintf(stdout, "\n");
     return chars_printed;
 }
+
+void list_write(OutBuf *ob, const List *pl, p_outbuf_ele_write f)
+{
+    NodeList *node = NULL;
+
+    if (ob == NULL || pl == NULL || f == NULL)
+    {
+        return;
+    }
+
+    if (list_isEmpty(pl))
+    {
+        outbuf_putString(ob, "Empty list\n");
+        return;
+    }
+
+    outbuf_putString(ob, "Size of list: ");
+    outbuf_putLong(ob, (long)list_size(pl));
+    outbuf_putChar(ob, '\n');
+    node = pl->last->next;
+
+    do
+    {
+        f(ob, node->data);
+        outbuf_putChar(ob, ' ');
+        node = node->next;
+    } while (node != pl->last->next);
+
+    outbuf_putChar(ob, '\n');
+}
@@ -28,6 +28,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "types.h"
+#include "outbuf.h"
 
 
 /**
@@ -186,4 +187,16 @@ size_t list_size(const List *pl);
  */
 int list_print(FILE *fp, const List *pl, P_ele_print f);
 
+/**
+ * @brief Public function that puts the content of a List in an OutBuf,
+ * in the format of list_print.
+ *
+ * @author Izan Robles
+ *
+ * @param ob Pointer to the OutBuf.
+ * @param pl Pointer to the List.
+ * @param f A pointer to the function that must be used to put the list elements.
+ */
+void list_write(OutBuf *ob, const List *pl, p_outbuf_ele_write f);
+
 #endif	/* LIST_H */
@@ -0,0 +1,276 @@
+/**
+ * @brief Implementation of list module as a circular array
+ * @author Izan Robles
+ *
+ * Same interface as list.c, linked instead of it. Elements are kept in a
+ * growable power of two ring buffer, so pushing and popping at either end
+ * and getting the size are O(1), with no allocation per element.
+ */
+
+#include "list.h"
+#include <string.h>
+
+#define LIST_INIT_CAPACITY 16
+
+struct _List
+{
+    void **data;        /* capacity slots, the list starts at front and wraps around */
+    size_t front;
+    size_t size;
+    size_t capacity;    /* Always a power of two */
+};
+
+/* Slot of the element at position i of the list */
+#define LIST_SLOT(pl, i) (((pl)->front + (i)) & ((pl)->capacity - 1))
+
+static Status _list_grow(List *pl);
+
+/* Doubles the buffer, unwrapping the elements to its start */
+static Status _list_grow(List *pl)
+{
+    void **data;
+    size_t capacity, first;
+
+    capacity = pl->capacity > 0 ? 2 * pl->capacity : LIST_INIT_CAPACITY;
+    if (!(data = (void **)malloc(capacity * sizeof(void *))))
+    {
+        return ERROR;
+    }
+
+    if (pl->size > 0)
+    {
+        first = pl->capacity - pl->front < pl->size ? pl->capacity - pl->front : pl->size;
+        memcpy(data, pl->data + pl->front, first * sizeof(void *));
+        memcpy(data + first, pl->data, (pl->size - first) * sizeof(void *));
+    }
+
+    free(pl->data);
+    pl->data = data;
+    pl->front = 0;
+    pl->capacity = capacity;
+
+    return OK;
+}
+
+List *list_new()
+{
+    List *pl = (List *)malloc(sizeof(List));
+
+    if (pl == NULL)
+    {
+        return NULL;
+    }
+
+    pl->data = NULL;
+    pl->front = 0;
+    pl->size = 0;
+    pl->capacity = 0;
+
+    return pl;
+}
+
+Bool list_isEmpty(const List *pl)
+{
+    if (pl == NULL || pl->size == 0)
+    {
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+Status list_pushFront(List *pl, void *e)
+{
+    if (pl == NULL || e == NULL)
+    {
+        return ERROR;
+    }
+
+    if (pl->size == pl->capacity && _list_grow(pl) == ERROR)
+    {
+        return ERROR;
+    }
+
+    pl->front = (pl->front - 1) & (pl->capacity - 1);
+    pl->data[pl->front] = e;
+    pl->size++;
+
+    return OK;
+}
+
+Status list_pushBack(List *pl, void *e)
+{
+    if (pl == NULL || e == NULL)
+    {
+        return ERROR;
+    }
+
+    if (pl->size == pl->capacity && _list_grow(pl) == ERROR)
+    {
+        return ERROR;
+    }
+
+    pl->data[LIST_SLOT(pl, pl->size)] = e;
+    pl->size++;
+
+    return OK;
+}
+
+Status list_pushInOrder(List *pl, void *e, P_ele_cmp f, int order)
+{
+    size_t pos, i;
+    int cmp_result;
+
+    if (pl == NULL || e == NULL || f == NULL)
+    {
+        return ERROR;
+    }
+
+    /* Same place as in list.c: before the first element e has to precede */
+    for (pos = 0; pos < pl->size; pos++)
+    {
+        cmp_result = f(e, pl->data[LIST_SLOT(pl, pos)]);
+        if ((order == 1 && cmp_result < 0) || (order == -1 && cmp_result > 0))
+        {
+            break;
+        }
+    }
+
+    if (pos == 0)
+    {
+        return list_pushFront(pl, e);
+    }
+
+    if (list_pushBack(pl, e) == ERROR)
+    {
+        return ERROR;
+    }
+
+    /* Shift the tail one slot back to open a gap at pos */
+    for (i = pl->size - 1; i > pos; i--)
+    {
+        pl->data[LIST_SLOT(pl, i)] = pl->data[LIST_SLOT(pl, i - 1)];
+    }
+    pl->data[LIST_SLOT(pl, pos)] = e;
+
+    return OK;
+}
+
+void *list_popFront(List *pl)
+{
+    void *data = NULL;
+
+    if (pl == NULL || pl->size == 0)
+    {
+        return NULL;
+    }
+
+    data = pl->data[pl->front];
+    pl->front = LIST_SLOT(pl, 1);
+    pl->size--;
+
+    return data;
+}
+
+void *list_popBack(List *pl)
+{
+    if (pl == NULL || pl->size == 0)
+    {
+        return NULL;
+    }
+
+    pl->size--;
+
+    return pl->data[LIST_SLOT(pl, pl->size)];
+}
+
+void list_free(List *pl)
+{
+    if (pl)
+    {
+        free(pl->data);
+        free(pl);
+    }
+}
+
+void list_free_with_elements(List *pl, P_ele_free f)
+{
+    size_t i;
+
+    if (!pl || !f)
+    {
+        return;
+    }
+
+    for (i = 0; i < pl->size; i++)
+    {
+        f(pl->data[LIST_SLOT(pl, i)]);
+    }
+
+    list_free(pl);
+}
+
+size_t list_size(const List *pl)
+{
+    if (pl == NULL)
+    {
+        return 0;
+    }
+
+    return pl->size;
+}
+
+int list_print(FILE *fp, const List *pl, P_ele_print f)
+{
+    int chars_printed = 0;
+    size_t i;
+
+    if (fp == NULL || pl == NULL || f == NULL)
+    {
+        return -1;
+    }
+
+    if (list_isEmpty(pl))
+    {
+        return fprintf(fp, "Empty list\n");
+    }
+
+    chars_printed = fprintf(fp, "Size of list: %lu\n", (unsigned long)pl->size);
+
+    for (i = 0; i < pl->size; i++)
+    {
+        chars_printed += f(fp, pl->data[LIST_SLOT(pl, i)]);
+        chars_printed += putc(' ', fp) == EOF ? 0 : 1;
+    }
+
+    fprintf(fp, "\n");
+    return chars_printed;
+}
+
+void list_write(OutBuf *ob, const List *pl, p_outbuf_ele_write f)
+{
+    size_t i;
+
+    if (ob == NULL || pl == NULL || f == NULL)
+    {
+        return;
+    }
+
+    if (list_isEmpty(pl))
+    {
+        outbuf_putString(ob, "Empty list\n");
+        return;
+    }
+
+    outbuf_putString(ob, "Size of list: ");
+    outbuf_putLong(ob, (long)pl->size);
+    outbuf_putChar(ob, '\n');
+
+    for (i = 0; i < pl->size; i++)
+    {
+        f(ob, pl->data[LIST_SLOT(pl, i)]);
+        outbuf_putChar(ob, ' ');
+    }
+
+    outbuf_putChar(ob, '\n');
+}
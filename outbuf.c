@@ -0,0 +1,130 @@
+/**
+ * @brief Implementation of outbuf module
+ * @author Izan Robles
+ */
+
+#include "outbuf.h"
+#include <string.h>
+
+/* Digits of the longest long, with its sign */
+#define OUTBUF_LONG_MAX 24
+
+static void _outbuf_write(OutBuf *ob);
+
+/* Writes the buffer to the stream and empties it */
+static void _outbuf_write(OutBuf *ob)
+{
+    size_t n;
+
+    if (ob->len > 0)
+    {
+        /* Only what fwrite took is counted, a short write is an error */
+        n = fwrite(ob->data, 1, ob->len, ob->pf);
+        if (n != ob->len)
+        {
+            ob->failed = TRUE;
+        }
+        ob->written += n;
+        ob->len = 0;
+    }
+}
+
+void outbuf_init(OutBuf *ob, FILE *pf, char *data, size_t size)
+{
+    if (ob == NULL)
+    {
+        return;
+    }
+
+    ob->pf = pf;
+    ob->data = data;
+    ob->size = size;
+    ob->len = 0;
+    ob->written = 0;
+    ob->failed = (pf == NULL || data == NULL || size == 0) ? TRUE : FALSE;
+}
+
+void outbuf_putChar(OutBuf *ob, char c)
+{
+    if (ob == NULL || ob->failed)
+    {
+        return;
+    }
+
+    if (ob->len == ob->size)
+    {
+        _outbuf_write(ob);
+    }
+
+    ob->data[ob->len++] = c;
+}
+
+void outbuf_putChars(OutBuf *ob, const char *s, size_t n)
+{
+    size_t room;
+
+    if (ob == NULL || s == NULL || ob->failed)
+    {
+        return;
+    }
+
+    while (n > 0)
+    {
+        if (ob->len == ob->size)
+        {
+            _outbuf_write(ob);
+        }
+
+        room = ob->size - ob->len < n ? ob->size - ob->len : n;
+        memcpy(ob->data + ob->len, s, room);
+        ob->len += room;
+        s += room;
+        n -= room;
+    }
+}
+
+void outbuf_putString(OutBuf *ob, const char *s)
+{
+    if (s != NULL)
+    {
+        outbuf_putChars(ob, s, strlen(s));
+    }
+}
+
+void outbuf_putLong(OutBuf *ob, long n)
+{
+    char digits[OUTBUF_LONG_MAX];
+    unsigned long u;
+    int i = OUTBUF_LONG_MAX;
+
+    /* Negated as unsigned, so LONG_MIN does not overflow */
+    u = n < 0 ? 0UL - (unsigned long)n : (unsigned long)n;
+
+    do
+    {
+        digits[--i] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u > 0);
+
+    if (n < 0)
+    {
+        digits[--i] = '-';
+    }
+
+    outbuf_putChars(ob, digits + i, OUTBUF_LONG_MAX - i);
+}
+
+long outbuf_flush(OutBuf *ob)
+{
+    if (ob == NULL || ob->pf == NULL)
+    {
+        return -1;
+    }
+
+    if (!ob->failed)
+    {
+        _outbuf_write(ob);
+    }
+
+    return ob->failed ? -1 : ob->written;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file outbuf.h
+ * @author Izan Robles
+ * @date 17 October 2026
+ * @brief Public interface for a buffered output sink.
+ *
+ * An OutBuf collects text in a buffer given by the caller and writes it
+ * to its FILE with one fwrite every time the buffer fills, so printing
+ * many small pieces does not cost a fprintf call each. Integers are
+ * formatted by hand instead of going through a format string.
+ *
+ * The OutBuf is meant to live on the stack of the function that prints:
+ * initialize it, put the text, and flush it before returning or before
+ * anything else writes to the same FILE.
+ *
+ * This OutBuf implementation currently provides the following functionality:
+ *
+ * - Initialize an OutBuf over a FILE and a buffer.
+ * - Put characters, strings and integers.
+ * - Flush the buffer and get the number of characters written.
+ *
+ * Containers print their elements into an OutBuf with a p_outbuf_ele_write
+ * function, the counterpart of their FILE * print functions.
+ *
+ */
+
+#ifndef OUTBUF_H
+#define OUTBUF_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "types.h"
+
+/**
+ * Size of the buffer used by the functions that print big structures.
+ */
+#define OUTBUF_BLOCK 65536
+
+/**
+ * OutBuf type definition: a buffered output sink. Its fields must only
+ * be used through the functions of this module.
+ */
+typedef struct _OutBuf OutBuf;
+
+struct _OutBuf
+{
+    FILE *pf;
+    char *data;         /* Buffer given by the caller */
+    size_t size;
+    size_t len;         /* Characters waiting to be written */
+    long written;       /* Characters already written to pf */
+    Bool failed;        /* Some fwrite failed */
+};
+
+/**
+ * @brief Data type for a pointer to a function that puts an element in an OutBuf.
+ * @author Izan Robles
+ */
+typedef void (*p_outbuf_ele_write)(OutBuf *, const void *);
+
+/**
+ * @brief Public function that initializes an OutBuf.
+ * @author Izan Robles
+ *
+ * @param ob Pointer to the OutBuf.
+ * @param pf Output stream.
+ * @param data Buffer where the text is kept until it is written.
+ * @param size Size of data, at least 1.
+ */
+void outbuf_init(OutBuf *ob, FILE *pf, char *data, size_t size);
+
+/**
+ * @brief Public function that puts a character.
+ * @author Izan Robles
+ *
+ * @param ob Pointer to the OutBuf.
+ * @param c Character to be put.
+ */
+void outbuf_putChar(OutBuf *ob, char c);
+
+/**
+ * @brief Public function that puts n characters.
+ * @author Izan Robles
+ *
+ * @param ob Pointer to the OutBuf.
+ * @param s Characters to be put, they do not need to end in '\0'.
+ * @param n Number of characters.
+ */
+void outbuf_putChars(OutBuf *ob, const char *s, size_t n);
+
+/**
+ * @brief Public function that puts a string.
+ * @author Izan Robles
+ *
+ * @param ob Pointer to the OutBuf.
+ * @param s String to be put.
+ */
+void outbuf_putString(OutBuf *ob, const char *s);
+
+/**
+ * @brief Public function that puts an integer in decimal, like "%ld".
+ * @author Izan Robles
+ *
+ * @param ob Pointer to the OutBuf.
+ * @param n Integer to be put.
+ */
+void outbuf_putLong(OutBuf *ob, long n);
+
+/**
+ * @brief Public function that writes the characters waiting in the buffer.
+ * @author Izan Robles
+ *
+ * @param ob Pointer to the OutBuf.
+ *
+ * @return The number of characters written since the OutBuf was
+ * initialized, or -1 if some of them could not be written.
+ */
+long outbuf_flush(OutBuf *ob);
+
+#endif /* OUTBUF_H */
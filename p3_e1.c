@@ -87,7 +87,7 @@ int main(int argc, char *argv[])
 {
     FILE *file = NULL;
     Delivery *delivery = NULL;
-    p_element_print f = vertex_print;
+    p_outbuf_ele_write f = vertex_write;
     p_element_free r = vertex_free;
     
     if (argc != 2)
@@ -112,7 +112,7 @@ int main(int argc, char *argv[])
     }
     printf("--> delivery created and filled\n");
     
-    if (delivery_run_plan(stdout, delivery, f, r) == ERROR)
+    if (delivery_run_plan_buffered(stdout, delivery, f, r) == ERROR)
     {
         printf("ERROR: could not print delivery\n");
         fclose(file);
@@ -15,7 +15,8 @@ Delivery *build_delivery(FILE *pf)
     int vertex_number, i;
     Delivery *delivery = NULL;
     void *temp = NULL;
-    p_element_free ffree = vertex_free;
+    VertexArena *arena = NULL;
+    p_element_free ffree = vertex_arena_release;
     p_element_print fprint = vertex_print;
 
     if (!pf)
@@ -47,6 +48,20 @@ Delivery *build_delivery(FILE *pf)
         return NULL;
     }
 
+    /* Make room in the plan for every vertex at once */
+    if (vertex_number > 0 && queue_reserve(delivery_getPlan(delivery), vertex_number) == ERROR)
+    {
+        delivery_free(delivery);
+        return NULL;
+    }
+
+    /* Vertices live in the delivery arena and go away with the delivery */
+    if (!(arena = delivery_getArena(delivery)))
+    {
+        delivery_free(delivery);
+        return NULL;
+    }
+
     /* Move to next line */
     fgetc(pf);
 
@@ -60,7 +75,7 @@ Delivery *build_delivery(FILE *pf)
             return NULL;
         }
 
-        temp = vertex_initFromString(vertex_desc);
+        temp = vertex_arena_initFromString(arena, vertex_desc);
         if (!temp)
         {
             delivery_free_products(delivery, ffree);
@@ -89,8 +104,8 @@ int main(int argc, char *argv[])
 {
     FILE *file = NULL;
     Delivery *delivery = NULL;
-    p_element_print f = vertex_print;
-    p_element_free r = vertex_free;
+    p_outbuf_ele_write f = vertex_write;
+    p_element_free r = vertex_arena_release;
     
     if (argc != 2)
     {
@@ -114,7 +129,7 @@ int main(int argc, char *argv[])
     }
     printf("--> delivery created and filled\n");
     
-    if (delivery_run_plan(stdout, delivery, f, r) == ERROR)
+    if (delivery_run_plan_buffered(stdout, delivery, f, r) == ERROR)
     {
         printf("ERROR: could not print delivery\n");
         fclose(file);
@@ -1,50 +1,112 @@
+#include "float_list.h"
+#include "float_skiplist.h"
 #include "list.h"
 #include "file_utils.h"
+#include <string.h>
 
-int main(int argc, char *argv[])
+static int bulk_sort(FILE *file, int order);
+static int list_sort(FILE *file, int order);
+
+/**
+ * Bulk mode: same output as the list based program, with the values read
+ * into one array and radix sorted. They are put in the order in which
+ * the lists would insert them first, so the stable sort breaks ties the
+ * same way list_pushInOrder does.
+ */
+static int bulk_sort(FILE *file, int order)
 {
-    FILE *file = NULL;
-    List *ls = NULL;
-    List *ls2 = NULL;
-    char *endptr;
-    int num, num_elements = 0, i, half;
-    float *temp_value = NULL;
-    P_ele_free ffree = (P_ele_free)free;
-    P_ele_cmp fcmp = float_cmp;
-    P_ele_print fpr = _float_print;
+    float *values = NULL;
+    float *sequence = NULL;
+    int num_elements = 0, i, k, half, n_even;
 
-    /*---------------------------------  Check arguments  ---------------------------------*/
+    printf("--> new list succesfully initialized\n");
 
-    if (argc < 3)
+    if (fscanf(file, "%d\n", &num_elements) != 1 || num_elements < 0)
     {
-        printf("Use: %s <file.txt> <1 or -1>\n", argv[0]);
+        printf("ERROR: could not read number of elements\n");
+        fclose(file);
         return 1;
     }
-    printf("--> number of arguments correct\n");
-
-    num = strtol(argv[2], &endptr, 10);
+    printf("--> number of elements saved\n");
 
-    if (*endptr != '\0')
+    values = (float *)malloc((num_elements > 0 ? num_elements : 1) * sizeof(float));
+    sequence = (float *)malloc((num_elements > 0 ? num_elements : 1) * sizeof(float));
+    if (!values || !sequence)
     {
-        printf("ERROR: invalid numeric input.\n");
+        printf("ERROR: memory allocation failed\n");
+        free(values);
+        free(sequence);
+        fclose(file);
         return 1;
     }
 
-    if (num != 1 && num != -1)
+    if (float_readArray(file, values, num_elements) != (size_t)num_elements)
     {
-        printf("ERROR: number must be 1 or -1\n");
+        printf("ERROR: could not read elements\n");
+        free(values);
+        free(sequence);
+        fclose(file);
         return 1;
     }
-    printf("--> valid numeric input\n");
+    printf("--> data succesfully saved in list\n");
 
-    /*---------------------------------  Read file  ---------------------------------*/
+    fclose(file);
+    printf("--> file closed\n");
+    printf("--> second list created\n");
 
-    if (!(file = fopen(argv[1], "r")))
+    /* The first list holds the even positions backwards and then the odd
+     * ones. Half of it is popped from the front and the rest from the back */
+    n_even = (num_elements + 1) / 2;
+    half = num_elements / 2;
+    for (k = 0; k < num_elements; k++)
     {
-        printf("ERROR: %s not found\n", argv[1]);
+        i = k < half ? k : num_elements - 1 - (k - half);
+        sequence[k] = i < n_even ? values[2 * (n_even - 1 - i)] : values[2 * (i - n_even) + 1];
+    }
+
+    if (float_radixSort(sequence, num_elements, order) != 0)
+    {
+        printf("ERROR: could not insert element in ordered list\n");
+        free(values);
+        free(sequence);
         return 1;
     }
-    printf("--> target file succesfully opened\n");
+    printf("--> elements ordered in the desired order\n");
+
+    if (num_elements == 0)
+    {
+        printf("Empty list\n");
+    }
+    else
+    {
+        printf("Size of list: %lu\n", (unsigned long)num_elements);
+        float_writeArray(stdout, sequence, num_elements, ' ');
+        printf("\n");
+    }
+
+    free(values);
+    free(sequence);
+    printf("--> all memory freed\n");
+    printf("--> program end\n");
+
+    return 0;
+}
+
+/**
+ * List mode: the original program, one malloc'd float per element kept
+ * in a List and sorted with list_pushInOrder. It is the only mode that
+ * uses list.h, so p3_e3 runs it on list.c and p3_e3_deque on list_deque.c.
+ */
+static int list_sort(FILE *file, int order)
+{
+    List *ls = NULL;
+    List *ls2 = NULL;
+    int num_elements = 0, i, half;
+    float *temp_value = NULL;
+    char *data = NULL;
+    OutBuf ob;
+    P_ele_free ffree = (P_ele_free)free;
+    P_ele_cmp fcmp = float_cmp;
 
     if (!(ls = list_new()))
     {
@@ -97,8 +159,6 @@ int main(int argc, char *argv[])
 
     fclose(file);
     printf("--> file closed\n");
-    
-    /*---------------------------------  Create new list and order elements  ---------------------------------*/
 
     if (!(ls2 = list_new()))
     {
@@ -110,10 +170,10 @@ int main(int argc, char *argv[])
 
     half = num_elements / 2; 
 
-    for (i = 0; i < half; i++)
+    for (i = 0; i < num_elements; i++)
     {
-        temp_value = list_popFront(ls);  
-        if (list_pushInOrder(ls2, temp_value, fcmp, num) == ERROR) 
+        temp_value = i < half ? list_popFront(ls) : list_popBack(ls);
+        if (list_pushInOrder(ls2, temp_value, fcmp, order) == ERROR) 
         {
             printf("ERROR: could not insert element in ordered list\n");
             free(temp_value);
@@ -123,25 +183,180 @@ int main(int argc, char *argv[])
         }
     }
 
-    for (i = 0; i < num_elements - half; i++)
+    printf("--> elements ordered in the desired order\n");
+
+    /* Printed through one OutBuf, or straight to stdout without memory for it */
+    if ((data = (char *)malloc(OUTBUF_BLOCK)) != NULL)
+    {
+        outbuf_init(&ob, stdout, data, OUTBUF_BLOCK);
+        list_write(&ob, ls2, float_write);
+        outbuf_flush(&ob);
+        free(data);
+    }
+    else
+    {
+        list_print(stdout, ls2, _float_print);
+    }
+
+    list_free_with_elements(ls2, ffree);
+    list_free_with_elements(ls, ffree);
+    printf("--> all memory freed\n");
+    printf("--> program end\n");
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *file = NULL;
+    FloatList *ls = NULL;
+    FloatSkipList *ls2 = NULL;
+    char *endptr;
+    int num, num_elements = 0, i, half;
+    float *cells = NULL;
+    float value;
+
+    /*---------------------------------  Check arguments  ---------------------------------*/
+
+    if (argc < 3)
+    {
+        printf("Use: %s <file.txt> <1 or -1> [bulk | list]\n", argv[0]);
+        return 1;
+    }
+    printf("--> number of arguments correct\n");
+
+    num = strtol(argv[2], &endptr, 10);
+
+    if (*endptr != '\0')
+    {
+        printf("ERROR: invalid numeric input.\n");
+        return 1;
+    }
+
+    if (num != 1 && num != -1)
+    {
+        printf("ERROR: number must be 1 or -1\n");
+        return 1;
+    }
+    printf("--> valid numeric input\n");
+
+    /*---------------------------------  Read file  ---------------------------------*/
+
+    if (!(file = fopen(argv[1], "r")))
+    {
+        printf("ERROR: %s not found\n", argv[1]);
+        return 1;
+    }
+    printf("--> target file succesfully opened\n");
+
+    if (argc > 3 && strcmp(argv[3], "bulk") == 0)
+    {
+        return bulk_sort(file, num);
+    }
+    if (argc > 3 && strcmp(argv[3], "list") == 0)
+    {
+        return list_sort(file, num);
+    }
+
+    if (!(ls = float_list_new()))
+    {
+        printf("ERROR: could not create list\n");
+        fclose(file);
+        return 1;
+    }
+    printf("--> new list succesfully initialized\n");
+
+    if (fscanf(file, "%d\n", &num_elements) != 1)
+    {
+        printf("ERROR: could not read number of elements\n");
+        float_list_free(ls);
+        fclose(file);
+        return 1;
+    }
+    printf("--> number of elements saved\n");
+
+    /* Values are stored inline, the list is allocated once. The array is
+     * only filled by one batch parse */
+    cells = (float *)malloc((num_elements > 0 ? num_elements : 1) * sizeof(float));
+    if (!cells || (num_elements > 0 && float_list_reserve(ls, num_elements) == ERROR))
+    {
+        printf("ERROR: memory allocation failed\n");
+        free(cells);
+        float_list_free(ls);
+        fclose(file);
+        return 1;
+    }
+
+    if (num_elements > 0 && float_readArray(file, cells, num_elements) != (size_t)num_elements)
+    {
+        printf("ERROR: could not read elements\n");
+        free(cells);
+        float_list_free(ls);
+        fclose(file);
+        return 1;
+    }
+
+    for (i = 0; i < num_elements; i++)
+    {
+        if (i % 2 == 0)
+        {
+            float_list_pushFront(ls, cells[i]);
+        }
+        else
+        {
+            float_list_pushBack(ls, cells[i]);
+        }
+    }
+    free(cells);
+    printf("--> data succesfully saved in list\n");
+
+    fclose(file);
+    printf("--> file closed\n");
+    
+    /*---------------------------------  Create new list and order elements  ---------------------------------*/
+
+    /* Sorted by a skip list: each insertion is O(log n) instead of a walk of
+     * the list. A FloatSkipList keeps the values in its nodes, compares
+     * them without calling float_cmp and takes the nodes from large blocks.
+     * The output is fully sorted: list_pushInOrder made the second element
+     * the tail when it went first, so some ascending outputs differ from the old
+     * program (grades.txt 1 prints "9.20 9.50 9.50" where it printed "9.50 9.20 9.50") */
+    if (!(ls2 = float_skiplist_new(num)))
+    {
+        printf("ERROR: could not create second list\n");
+        float_list_free(ls);
+        return 1;
+    }
+    printf("--> second list created\n");
+
+    half = num_elements / 2; 
+
+    for (i = 0; i < num_elements; i++)
     {
-        temp_value = list_popBack(ls);  
-        if (list_pushInOrder(ls2, temp_value, fcmp, num) == ERROR) 
+        if (i < half)
+        {
+            float_list_popFront(ls, &value);
+        }
+        else
+        {
+            float_list_popBack(ls, &value);
+        }
+
+        if (float_skiplist_insert(ls2, value) == ERROR) 
         {
             printf("ERROR: could not insert element in ordered list\n");
-            free(temp_value);
-            list_free_with_elements(ls, ffree);
-            list_free_with_elements(ls2, ffree);
+            float_list_free(ls);
+            float_skiplist_free(ls2);
             return 1;
         }
     }
 
     printf("--> elements ordered in the desired order\n");
 
-    list_print(stdout, ls2, fpr);  
+    float_skiplist_print(stdout, ls2);
 
-    list_free_with_elements(ls2, ffree);
-    list_free_with_elements(ls, ffree);
+    float_skiplist_free(ls2);
+    float_list_free(ls);
     printf("--> all memory freed\n");
     printf("--> program end\n");
 
@@ -5,16 +5,48 @@
 
 #include "queue.h"
 
-#define MAX_QUEUE 100
+#define INIT_CAPACITY 16
+#define FCT_CAPACITY 2
 
+/* The capacity is always a power of two, so positions wrap with a mask */
 struct _Queue
 {
-    void *data[MAX_QUEUE];
-    void **front;
-    void **rear;
+    void **data;
+    size_t front;
     size_t size;
+    size_t capacity;
 };
 
+/* Private functions */
+static Status _queue_resize(Queue *q, size_t capacity);
+
+/**
+ * Moves the elements to a new buffer of the given capacity, unwrapping
+ * them so that the front ends up at position 0.
+ */
+static Status _queue_resize(Queue *q, size_t capacity)
+{
+    void **new_data;
+    size_t i;
+
+    if (!(new_data = (void **)malloc(capacity * sizeof(void *))))
+    {
+        return ERROR;
+    }
+
+    for (i = 0; i < q->size; i++)
+    {
+        new_data[i] = q->data[(q->front + i) & (q->capacity - 1)];
+    }
+
+    free(q->data);
+    q->data = new_data;
+    q->front = 0;
+    q->capacity = capacity;
+
+    return OK;
+}
+
 Queue *queue_new()
 {
     Queue *q = NULL;
@@ -23,9 +55,15 @@ Queue *queue_new()
         return NULL;
     }
 
-    q->front = q->data;
-    q->rear = q->data;
+    if (!(q->data = (void **)malloc(INIT_CAPACITY * sizeof(void *))))
+    {
+        free(q);
+        return NULL;
+    }
+
+    q->front = 0;
     q->size = 0;
+    q->capacity = INIT_CAPACITY;
 
     return q;
 }
@@ -34,10 +72,36 @@ void queue_free(Queue *q)
 {
     if (q)
     {
+        free(q->data);
         free(q);
     }
 }
 
+Status queue_reserve(Queue *q, size_t n)
+{
+    size_t capacity;
+
+    if (!q)
+    {
+        return ERROR;
+    }
+
+    if (n <= q->capacity)
+    {
+        return OK;
+    }
+
+    for (capacity = q->capacity; capacity < n; capacity *= FCT_CAPACITY)
+    {
+        if (capacity > ((size_t)-1) / FCT_CAPACITY)
+        {
+            return ERROR;
+        }
+    }
+
+    return _queue_resize(q, capacity);
+}
+
 Bool queue_isEmpty(const Queue *q)
 {
     if (q && q->size == 0)
@@ -52,14 +116,17 @@ Bool queue_isEmpty(const Queue *q)
 
 Status queue_push(Queue *q, void *ele)
 {
-    if (!q || q->size >= MAX_QUEUE)
+    if (!q)
     {
         return ERROR;
     }
-    
-    *(q->rear) = ele;
 
-    q->rear = q->data + ((q->rear - q->data + 1) % MAX_QUEUE);
+    if (q->size == q->capacity && queue_reserve(q, q->capacity + 1) == ERROR)
+    {
+        return ERROR;
+    }
+
+    q->data[(q->front + q->size) & (q->capacity - 1)] = ele;
     q->size++;
 
     return OK;
@@ -67,14 +134,15 @@ Status queue_push(Queue *q, void *ele)
 
 void *queue_pop(Queue *q)
 {
-    void *ele = *(q->front);
+    void *ele;
 
     if (!q || q->size == 0)
     {
         return NULL;
     }
-    
-    q->front = q->data + ((q->front - q->data + 1) % MAX_QUEUE);
+
+    ele = q->data[q->front];
+    q->front = (q->front + 1) & (q->capacity - 1);
     q->size--;
     return ele;
 }
@@ -86,7 +154,7 @@ void *queue_getFront(const Queue *q)
         return NULL;
     }
 
-    return *(q->front);
+    return q->data[q->front];
 }
 
 void *queue_getBack(const Queue *q)
@@ -96,7 +164,7 @@ void *queue_getBack(const Queue *q)
         return NULL;
     }
 
-    return *(q->data + ((q->rear - q->data - 1 + MAX_QUEUE) % MAX_QUEUE));
+    return q->data[(q->front + q->size - 1) & (q->capacity - 1)];
 }
 
 size_t queue_size(const Queue *q)
@@ -114,8 +182,8 @@ size_t queue_size(const Queue *q)
 
 int queue_print(FILE *fp, const Queue *q, p_queue_ele_print f)
 {
-    int count = 0, i;
-    const void *const *ptr = (const void *const *)q->front;
+    int count = 0;
+    size_t i;
 
     if (!fp || !q || !f)
     {
@@ -124,11 +192,22 @@ int queue_print(FILE *fp, const Queue *q, p_queue_ele_print f)
 
     for (i = 0; i < q->size; i++)
     {
-        count += f(fp, *ptr);
-        ptr = (const void *const *)(q->data + ((ptr - (const void *const *)q->data + 1) % MAX_QUEUE));
+        count += f(fp, q->data[(q->front + i) & (q->capacity - 1)]);
     }
     return count;
 }
 
+void queue_write(OutBuf *ob, const Queue *q, p_outbuf_ele_write f)
+{
+    size_t i;
 
+    if (!ob || !q || !f)
+    {
+        return;
+    }
 
+    for (i = 0; i < q->size; i++)
+    {
+        f(ob, q->data[(q->front + i) & (q->capacity - 1)]);
+    }
+}
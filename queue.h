@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "types.h"
+#include "outbuf.h"
 
 /** 
  * @brief Data type to declare a queue variable.
@@ -41,6 +42,20 @@ Queue *queue_new();
  *  */
 void queue_free(Queue *q);
 
+/**
+ * @brief Makes room in the queue for at least n elements, so that the
+ * following pushes up to that size do not need to grow the buffer.
+ * The queue grows by itself when it gets full, so calling this function
+ * is only an optimization for callers that know the final size.
+ * @author Izan Robles
+ *
+ * @param q A pointer to the queue.
+ * @param n Number of elements the queue must be able to hold.
+ *
+ * @return OK on success, ERROR otherwise.
+ *  */
+Status queue_reserve(Queue *q, size_t n);
+
 /**
  * @brief Checks whether the queue is empty or not.
  * @author Izan Robles
@@ -54,7 +69,8 @@ Bool queue_isEmpty(const Queue *q);
 /**
  * @brief This function is used to insert an element at the back position of a 
  * queue. A reference to the element is added to the queue container and the size 
- * is increased by 1. Time complexity: O(1).
+ * is increased by 1. The container doubles its capacity when it is full. 
+ * Time complexity: amortized O(1).
  * @author Izan Robles
  * 
  * @param q A pointer to the queue.
@@ -122,4 +138,15 @@ size_t queue_size(const Queue *q);
  *  */
 int queue_print(FILE *fp, const Queue *q, p_queue_ele_print f);
 
+/**
+ * @brief  This function puts the queue content in an OutBuf, in the
+ * format of queue_print.
+ * @author Izan Robles
+ * 
+ * @param ob A pointer to the OutBuf.
+ * @param q A pointer to the queue to be printed. 
+ * @param f A pointer to the function that must be used to put the queue elements.
+ *  */
+void queue_write(OutBuf *ob, const Queue *q, p_outbuf_ele_write f);
+
 #endif	/* QUEUE_H */
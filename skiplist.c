@@ -0,0 +1,293 @@
+/**
+ * @brief Implementation of skiplist module
+ * @author Izan Robles
+ */
+
+#include "skiplist.h"
+
+/* Every level holds about a quarter of the nodes of the one below */
+#define SKIP_MAX_LEVEL 24
+#define SKIP_LEVEL_BITS 2
+
+struct _SkipNode
+{
+    void *data;
+    struct _SkipNode *next[1];  /* level pointers, the node is allocated with room for all of them */
+};
+
+struct _SkipList
+{
+    SkipNode *head;         /* Holds no element, has SKIP_MAX_LEVEL pointers */
+    int level;              /* Levels in use */
+    size_t size;
+    P_ele_cmp cmp;
+    int order;
+    unsigned long seed;     /* xorshift state used to pick node levels */
+};
+
+static SkipNode *_skipnode_new(void *e, int level);
+static int _skiplist_randomLevel(SkipList *sl);
+static Bool _skiplist_precedes(const SkipList *sl, const void *e, const void *other);
+
+static SkipNode *_skipnode_new(void *e, int level)
+{
+    SkipNode *n;
+    int i;
+
+    if (!(n = (SkipNode *)malloc(sizeof(SkipNode) + (level - 1) * sizeof(SkipNode *))))
+    {
+        return NULL;
+    }
+
+    n->data = e;
+    for (i = 0; i < level; i++)
+    {
+        n->next[i] = NULL;
+    }
+
+    return n;
+}
+
+static int _skiplist_randomLevel(SkipList *sl)
+{
+    unsigned long x = sl->seed;
+    int level = 1;
+
+    x ^= (x << 13) & 0xFFFFFFFFUL;
+    x ^= x >> 17;
+    x ^= (x << 5) & 0xFFFFFFFFUL;
+    sl->seed = x;
+
+    while (level < SKIP_MAX_LEVEL && (x & ((1UL << SKIP_LEVEL_BITS) - 1)) == 0)
+    {
+        level++;
+        x >>= SKIP_LEVEL_BITS;
+    }
+
+    return level;
+}
+
+/* TRUE if e goes before other, with the rule of list_pushInOrder */
+static Bool _skiplist_precedes(const SkipList *sl, const void *e, const void *other)
+{
+    int cmp_result = sl->cmp(e, other);
+
+    return ((sl->order == 1 && cmp_result < 0) || (sl->order == -1 && cmp_result > 0)) ? TRUE : FALSE;
+}
+
+SkipList *skiplist_new(P_ele_cmp f, int order)
+{
+    SkipList *sl = NULL;
+
+    if (f == NULL || (order != 1 && order != -1))
+    {
+        return NULL;
+    }
+
+    if (!(sl = (SkipList *)malloc(sizeof(SkipList))))
+    {
+        return NULL;
+    }
+
+    if (!(sl->head = _skipnode_new(NULL, SKIP_MAX_LEVEL)))
+    {
+        free(sl);
+        return NULL;
+    }
+
+    sl->level = 1;
+    sl->size = 0;
+    sl->cmp = f;
+    sl->order = order;
+    sl->seed = 2463534242UL;
+
+    return sl;
+}
+
+Bool skiplist_isEmpty(const SkipList *sl)
+{
+    if (sl == NULL || sl->size == 0)
+    {
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+Status skiplist_insert(SkipList *sl, void *e)
+{
+    SkipNode *update[SKIP_MAX_LEVEL];
+    SkipNode *x, *n;
+    int i, level;
+
+    if (sl == NULL || e == NULL)
+    {
+        return ERROR;
+    }
+
+    /* On every level, stop at the last node that e does not precede */
+    x = sl->head;
+    for (i = sl->level - 1; i >= 0; i--)
+    {
+        while (x->next[i] != NULL && !_skiplist_precedes(sl, e, x->next[i]->data))
+        {
+            x = x->next[i];
+        }
+        update[i] = x;
+    }
+
+    level = _skiplist_randomLevel(sl);
+    if (!(n = _skipnode_new(e, level)))
+    {
+        return ERROR;
+    }
+
+    for (i = sl->level; i < level; i++)
+    {
+        update[i] = sl->head;
+    }
+    if (level > sl->level)
+    {
+        sl->level = level;
+    }
+
+    for (i = 0; i < level; i++)
+    {
+        n->next[i] = update[i]->next[i];
+        update[i]->next[i] = n;
+    }
+    sl->size++;
+
+    return OK;
+}
+
+void *skiplist_popFront(SkipList *sl)
+{
+    SkipNode *first;
+    void *data;
+    int i;
+
+    if (sl == NULL || sl->size == 0)
+    {
+        return NULL;
+    }
+
+    /* The first node is right after the head on every level it has */
+    first = sl->head->next[0];
+    for (i = 0; i < sl->level && sl->head->next[i] == first; i++)
+    {
+        sl->head->next[i] = first->next[i];
+    }
+    while (sl->level > 1 && sl->head->next[sl->level - 1] == NULL)
+    {
+        sl->level--;
+    }
+
+    data = first->data;
+    free(first);
+    sl->size--;
+
+    return data;
+}
+
+SkipNode *skiplist_first(const SkipList *sl)
+{
+    if (sl == NULL)
+    {
+        return NULL;
+    }
+
+    return sl->head->next[0];
+}
+
+SkipNode *skiplist_next(const SkipNode *n)
+{
+    if (n == NULL)
+    {
+        return NULL;
+    }
+
+    return n->next[0];
+}
+
+void *skiplist_data(const SkipNode *n)
+{
+    if (n == NULL)
+    {
+        return NULL;
+    }
+
+    return n->data;
+}
+
+void skiplist_free(SkipList *sl)
+{
+    SkipNode *n, *next;
+
+    if (sl == NULL)
+    {
+        return;
+    }
+
+    for (n = sl->head; n != NULL; n = next)
+    {
+        next = n->next[0];
+        free(n);
+    }
+
+    free(sl);
+}
+
+void skiplist_free_with_elements(SkipList *sl, P_ele_free f)
+{
+    SkipNode *n;
+
+    if (sl == NULL || f == NULL)
+    {
+        return;
+    }
+
+    for (n = sl->head->next[0]; n != NULL; n = n->next[0])
+    {
+        f(n->data);
+    }
+
+    skiplist_free(sl);
+}
+
+size_t skiplist_size(const SkipList *sl)
+{
+    if (sl == NULL)
+    {
+        return 0;
+    }
+
+    return sl->size;
+}
+
+int skiplist_print(FILE *fp, const SkipList *sl, P_ele_print f)
+{
+    int chars_printed = 0;
+    SkipNode *n;
+
+    if (fp == NULL || sl == NULL || f == NULL)
+    {
+        return -1;
+    }
+
+    if (skiplist_isEmpty(sl))
+    {
+        return fprintf(fp, "Empty list\n");
+    }
+
+    chars_printed = fprintf(fp, "Size of list: %lu\n", (unsigned long)sl->size);
+
+    for (n = sl->head->next[0]; n != NULL; n = n->next[0])
+    {
+        chars_printed += f(fp, n->data);
+        chars_printed += putc(' ', fp) == EOF ? 0 : 1;
+    }
+
+    fprintf(fp, "\n");
+    return chars_printed;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file skiplist.h
+ * @author Izan Robles
+ * @date 17 October 2026
+ * @brief Public interface for a sorted Skip List implementation.
+ *
+ * The SkipList keeps arbitrary elements, received as pointers to void,
+ * sorted with the comparison function and order given when creating it.
+ * It follows the rules of list_pushInOrder, so it can replace an ordered
+ * List: an element goes right before the first one it has to precede,
+ * which keeps equal elements in insertion order. Inserting takes
+ * O(log n) expected time instead of the O(n) walk of a List.
+ *
+ * This SkipList implementation currently provides the following functionality:
+ *
+ * - Create and destroy a SkipList.
+ * - Insert an element in order.
+ * - Pop the first element.
+ * - Walk the elements in order.
+ * - Get the number of elements in a SkipList.
+ * - Print a SkipList.
+ *
+ */
+
+#ifndef SKIPLIST_H
+#define SKIPLIST_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "types.h"
+#include "list.h"
+
+/**
+ * SkipList type definition: a sorted list of arbitrary elements.
+ */
+typedef struct _SkipList SkipList;
+
+/**
+ * SkipNode type definition: position of an element in a SkipList, used
+ * to walk its elements in order.
+ */
+typedef struct _SkipNode SkipNode;
+
+/**
+ * @brief Public function that creates a new SkipList.
+ * @author Izan Robles
+ *
+ * @param f A pointer to the function that must be used to compare the elements.
+ * @param order 1 for a crescent list and -1 for a decrescent list.
+ *
+ * @return Returns the address of the new SkipList, or NULL in case of error.
+ */
+SkipList *skiplist_new(P_ele_cmp f, int order);
+
+/**
+ * @brief Public function that checks if a SkipList is empty.
+ * @author Izan Robles
+ *
+ * @param sl Pointer to the SkipList.
+ *
+ * @return Bool value TRUE if the SkipList is empty or NULL, Bool value FALSE
+ * otherwise.
+ */
+Bool skiplist_isEmpty(const SkipList *sl);
+
+/**
+ * @brief Public function that inserts an element in its place.
+ * @author Izan Robles
+ *
+ * @param sl Pointer to the SkipList.
+ * @param e Pointer to the element to be inserted into the SkipList.
+ *
+ * @return Status value OK if the insertion could be done, Status value ERROR
+ * otherwise.
+ */
+Status skiplist_insert(SkipList *sl, void *e);
+
+/**
+ * @brief Public function that pops the first element from a SkipList.
+ * @author Izan Robles
+ *
+ * @param sl Pointer to the SkipList.
+ *
+ * @return Pointer to the extracted element, NULL if the SkipList is empty or NULL.
+ */
+void *skiplist_popFront(SkipList *sl);
+
+/**
+ * @brief Public function that returns the position of the first element.
+ * @author Izan Robles
+ *
+ * @code
+ * SkipNode *n;
+ * for (n = skiplist_first(sl); n != NULL; n = skiplist_next(n))
+ * {
+ *     use(skiplist_data(n));
+ * }
+ * @endcode
+ *
+ * @param sl Pointer to the SkipList.
+ *
+ * @return The first position, or NULL if the SkipList is empty or NULL.
+ */
+SkipNode *skiplist_first(const SkipList *sl);
+
+/**
+ * @brief Public function that returns the position that follows another.
+ * @author Izan Robles
+ *
+ * @param n A position of the SkipList.
+ *
+ * @return The next position, or NULL if n is the last one or NULL.
+ */
+SkipNode *skiplist_next(const SkipNode *n);
+
+/**
+ * @brief Public function that returns the element at a position.
+ * @author Izan Robles
+ *
+ * @param n A position of the SkipList.
+ *
+ * @return Pointer to the element, or NULL if n is NULL.
+ */
+void *skiplist_data(const SkipNode *n);
+
+/**
+ * @brief Public function that frees a SkipList.
+ * @author Izan Robles
+ *
+ * @param sl Pointer to the SkipList.
+ */
+void skiplist_free(SkipList *sl);
+
+/**
+ * @brief Public function that frees a SkipList and all its elements.
+ * @author Izan Robles
+ *
+ * @param sl Pointer to the SkipList.
+ * @param f A pointer to the function that must be used to free the elements.
+ */
+void skiplist_free_with_elements(SkipList *sl, P_ele_free f);
+
+/**
+ * @brief Public function that returns the number of elements in a SkipList.
+ * @author Izan Robles
+ *
+ * @param sl Pointer to the SkipList.
+ *
+ * @return Returns the number of elements in the SkipList, or 0 if it is NULL.
+ */
+size_t skiplist_size(const SkipList *sl);
+
+/**
+ * @brief Public function that prints the content of a SkipList, in order
+ * and in the same format as list_print.
+ * @author Izan Robles
+ *
+ * @param fp Output stream.
+ * @param sl Pointer to the SkipList.
+ * @param f A pointer to the function that must be used to print the elements.
+ *
+ * @return The number of characters printed, or a negative value if an
+ * error occurs.
+ */
+int skiplist_print(FILE *fp, const SkipList *sl, P_ele_print f);
+
+#endif /* SKIPLIST_H */
@@ -6,69 +6,141 @@
 
 #include "vertex.h"
 #include <string.h>
+#include <limits.h>
+
+/* Slabs start with ARENA_MIN_SLAB vertices and double up to ARENA_MAX_SLAB */
+#define ARENA_MIN_SLAB 64
+#define ARENA_MAX_SLAB 65536
+
+typedef struct _VertexSlab
+{
+	struct _VertexSlab *next;	/* Slab filled before this one */
+	Vertex *vertices;
+	int capacity;
+} _VertexSlab;
+
+struct _VertexArena
+{
+	_VertexSlab *slabs;	/* Newest slab first, the only one with free records */
+	int used;			/* Records handed out from the newest slab */
+};
+
+static void _vertex_reset(Vertex *v);
+static void _vertex_parseBuffer(Vertex *v, const char *buf, size_t len);
 
 /*----------------------------------------------------------------------------------------*/
-Status vertex_setField(Vertex *v, char *key, char *value);
+Vertex *vertex_initFromString(char *descr)
+{
+	Vertex *v;
 
-Status vertex_setField(Vertex *v, char *key, char *value)
+	/* Check args: */
+	if (!descr)
+		return NULL;
+
+	/* Allocate memory for vertex: */
+	v = vertex_init();
+	if (!v)
+		return NULL;
+
+	_vertex_parseBuffer(v, descr, strlen(descr));
+
+	return v;
+}
+
+/*----------------------------------------------------------------------------------------*/
+static Bool _is_separator(char c);
+static long _parse_long(const char *p, const char *end);
+
+static Bool _is_separator(char c)
 {
-	if (!key || !value || !v)
-		return ERROR;
+	return (c == ' ' || c == '\t' || c == '\n' || c == '\r') ? TRUE : FALSE;
+}
 
-	if (strcmp(key, "id") == 0)
-	{
-		return vertex_setId(v, atol(value));
-	}
-	else if (strcmp(key, "tag") == 0)
+/* Same result as strtol on the characters in [p, end), out of range values are clamped */
+static long _parse_long(const char *p, const char *end)
+{
+	long value = 0;
+	int sign = 1;
+
+	if (p < end && (*p == '-' || *p == '+'))
 	{
-		return vertex_setTag(v, value);
+		sign = (*p == '-') ? -1 : 1;
+		p++;
 	}
-	else if (strcmp(key, "state") == 0)
+
+	for (; p < end && *p >= '0' && *p <= '9'; p++)
 	{
-		return vertex_setState(v, (Label)atoi(value));
+		if (value > (LONG_MAX - (*p - '0')) / 10)
+		{
+			return sign > 0 ? LONG_MAX : LONG_MIN;
+		}
+		value = 10 * value + (*p - '0');
 	}
 
-	return ERROR;
+	return sign * value;
 }
 
 /*----------------------------------------------------------------------------------------*/
-Vertex *vertex_initFromString(char *descr)
+Vertex *vertex_initFromBuffer(const char *buf, size_t len)
 {
-	char buffer[1024];
-	char *token;
-	char *key;
-	char *value;
-	char *p;
 	Vertex *v;
 
-	/* Check args: */
-	if (!descr)
+	if (!buf)
 		return NULL;
 
-	/* Allocate memory for vertex: */
 	v = vertex_init();
 	if (!v)
 		return NULL;
 
-	/* Read and tokenize description: */
-	sprintf(buffer, "%s", descr);
-	token = strtok(buffer, " \t\n");
-	while (token)
+	_vertex_parseBuffer(v, buf, len);
+
+	return v;
+}
+
+/* Sets the fields of v named in the len characters of buf */
+static void _vertex_parseBuffer(Vertex *v, const char *buf, size_t len)
+{
+	const char *p, *end, *token, *colon;
+	size_t key_len, value_len;
+
+	end = buf + len;
+	p = buf;
+	while (p < end)
 	{
-		p = strchr(token, ':');
-		if (!p)
+		/* Find the next token */
+		while (p < end && _is_separator(*p))
+			p++;
+		token = p;
+		while (p < end && !_is_separator(*p))
+			p++;
+		if (token == p)
+			break;
+
+		colon = memchr(token, ':', p - token);
+		if (!colon)
 			continue;
 
-		*p = '\0';
-		key = token;
-		value = p + 1;
-
-		vertex_setField(v, key, value);
+		key_len = colon - token;
+		value_len = p - (colon + 1);
 
-		token = strtok(NULL, " \t\n");
+		/* Keys are matched by length first, values are read in place */
+		if (key_len == 2 && strncmp(token, "id", 2) == 0)
+		{
+			vertex_setId(v, _parse_long(colon + 1, p));
+		}
+		else if (key_len == 3 && strncmp(token, "tag", 3) == 0)
+		{
+			if (value_len <= TAG_LENGTH - 1)
+			{
+				memcpy(v->tag, colon + 1, value_len);
+				v->tag[value_len] = '\0';
+			}
+		}
+		else if (key_len == 5 && strncmp(token, "state", 5) == 0)
+		{
+			vertex_setState(v, (Label)_parse_long(colon + 1, p));
+		}
 	}
-
-	return v;
 }
 
 /*----------------------------------------------------------------------------------------*/
@@ -76,29 +148,31 @@ Vertex *vertex_init()
 {
 	Vertex *v = NULL;
 
-	if (!(v = (Vertex *)malloc(sizeof(Vertex))))
+	/*means length of tag in vertex is too low to initalize*/
+	if (TAG_LENGTH < 1)
 	{
 		return NULL;
 	}
 
-	vertex_setState(v, WHITE);
-	vertex_setId(v, 0);
-	v->index = -1;
-
-	if (TAG_LENGTH > 0)
-	{
-		v->tag[0] = '\0';
-	}
-	else
+	if (!(v = (Vertex *)malloc(sizeof(Vertex))))
 	{
-		/*means length of tag in vertex is too low to initalize*/
-		free(v);
 		return NULL;
 	}
 
+	_vertex_reset(v);
+
 	return v;
 }
 
+/* Default fields of a new vertex */
+static void _vertex_reset(Vertex *v)
+{
+	vertex_setState(v, WHITE);
+	vertex_setId(v, 0);
+	v->index = -1;
+	v->tag[0] = '\0';
+}
+
 /*----------------------------------------------------------------------------------------*/
 void vertex_free(void *v)
 {
@@ -263,6 +337,8 @@ void *vertex_copy(const void *src)
 int vertex_print(FILE *pf, const void *v)
 {
 	const Vertex *source;
+	char data[TAG_LENGTH + 64];
+	OutBuf ob;
 
 	if (pf == NULL || v == NULL)
 	{
@@ -271,7 +347,31 @@ int vertex_print(FILE *pf, const void *v)
 
 	source = (const Vertex *)v;
 
-	return fprintf(pf, "[%ld, %s, %d]", vertex_getId(source), vertex_getTag(source), vertex_getState(source));
+	outbuf_init(&ob, pf, data, sizeof(data));
+	vertex_write(&ob, source);
+
+	return (int)outbuf_flush(&ob);
+}
+
+/*----------------------------------------------------------------------------------------*/
+void vertex_write(OutBuf *ob, const void *v)
+{
+	const Vertex *source;
+
+	if (ob == NULL || v == NULL)
+	{
+		return;
+	}
+
+	source = (const Vertex *)v;
+
+	outbuf_putChar(ob, '[');
+	outbuf_putLong(ob, vertex_getId(source));
+	outbuf_putChars(ob, ", ", 2);
+	outbuf_putString(ob, vertex_getTag(source));
+	outbuf_putChars(ob, ", ", 2);
+	outbuf_putLong(ob, vertex_getState(source));
+	outbuf_putChar(ob, ']');
 }
 
 /*----------------------------------------------------------------------------------------*/
@@ -323,3 +423,139 @@ int vertex_get_index(const Vertex *v)
 
 	return v->index;
 }
+
+/*----------------------------------------------------------------------------------------*/
+VertexArena *vertex_arena_init()
+{
+	VertexArena *a = NULL;
+
+	if (!(a = (VertexArena *)malloc(sizeof(VertexArena))))
+	{
+		return NULL;
+	}
+
+	a->slabs = NULL;
+	a->used = 0;
+
+	return a;
+}
+
+/*----------------------------------------------------------------------------------------*/
+void vertex_arena_free(VertexArena *a)
+{
+	_VertexSlab *slab, *next;
+
+	if (a == NULL)
+	{
+		return;
+	}
+
+	for (slab = a->slabs; slab != NULL; slab = next)
+	{
+		next = slab->next;
+		free(slab->vertices);
+		free(slab);
+	}
+
+	free(a);
+}
+
+/*----------------------------------------------------------------------------------------*/
+void vertex_arena_clear(VertexArena *a)
+{
+	_VertexSlab *slab, *next;
+
+	if (a == NULL || a->slabs == NULL)
+	{
+		return;
+	}
+
+	/* The newest slab is the largest one, it is kept for the next vertices */
+	for (slab = a->slabs->next; slab != NULL; slab = next)
+	{
+		next = slab->next;
+		free(slab->vertices);
+		free(slab);
+	}
+
+	a->slabs->next = NULL;
+	a->used = 0;
+}
+
+/*----------------------------------------------------------------------------------------*/
+Vertex *vertex_arena_new(VertexArena *a)
+{
+	_VertexSlab *slab = NULL;
+	Vertex *v;
+	int capacity;
+
+	if (a == NULL || TAG_LENGTH < 1)
+	{
+		return NULL;
+	}
+
+	if (a->slabs == NULL || a->used == a->slabs->capacity)
+	{
+		capacity = a->slabs == NULL ? ARENA_MIN_SLAB : 2 * a->slabs->capacity;
+		if (capacity > ARENA_MAX_SLAB)
+		{
+			capacity = ARENA_MAX_SLAB;
+		}
+
+		if (!(slab = (_VertexSlab *)malloc(sizeof(_VertexSlab))))
+		{
+			return NULL;
+		}
+		if (!(slab->vertices = (Vertex *)malloc(capacity * sizeof(Vertex))))
+		{
+			free(slab);
+			return NULL;
+		}
+
+		slab->capacity = capacity;
+		slab->next = a->slabs;
+		a->slabs = slab;
+		a->used = 0;
+	}
+
+	v = a->slabs->vertices + a->used++;
+	_vertex_reset(v);
+
+	return v;
+}
+
+/*----------------------------------------------------------------------------------------*/
+Vertex *vertex_arena_initFromString(VertexArena *a, char *descr)
+{
+	Vertex *v;
+
+	if (!descr || !(v = vertex_arena_new(a)))
+	{
+		return NULL;
+	}
+
+	_vertex_parseBuffer(v, descr, strlen(descr));
+
+	return v;
+}
+
+/*----------------------------------------------------------------------------------------*/
+Vertex *vertex_arena_initFromBuffer(VertexArena *a, const char *buf, size_t len)
+{
+	Vertex *v;
+
+	if (!buf || !(v = vertex_arena_new(a)))
+	{
+		return NULL;
+	}
+
+	_vertex_parseBuffer(v, buf, len);
+
+	return v;
+}
+
+/*----------------------------------------------------------------------------------------*/
+void vertex_arena_release(void *v)
+{
+	(void)v;
+}
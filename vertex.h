@@ -9,6 +9,7 @@
 #define VERTEX_H_
 
 #include "types.h"
+#include "outbuf.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
@@ -44,6 +45,12 @@ struct _Vertex
     int index;
 }; 
 
+/**
+ * @brief Slab allocator for vertices. Vertices taken from an arena are
+ * not freed one by one, they all go away with vertex_arena_free.
+ **/
+typedef struct _VertexArena VertexArena;
+
 /**
  * @brief Constructor. Initialize a vertex.
  * 
@@ -67,7 +74,11 @@ Vertex * vertex_init ();
  * a set of key:value pairs separated by any amount of whitespace, 
  * where the key can be any of id, tag or state. 
  * No space is allowed in the definition of a key:value pair.
- * The key:value pairs can be provided in any order.
+ * The key:value pairs can be provided in any order. Tokens without
+ * a ':' and tags longer than TAG_LENGTH - 1 are ignored.
+ *
+ * The description is parsed in place in a single pass, with no length
+ * limit and no shared state, so it can be called from several threads.
  * 
  * Examples
  *
@@ -83,6 +94,24 @@ Vertex * vertex_init ();
 */
 Vertex *vertex_initFromString(char *descr);
 
+/**
+ * @brief Constructor. Initialize a vertex from a description that is
+ * not null terminated.
+ * 
+ * @author Izan Robles
+ * 
+ * Accepts the same descriptions as vertex_initFromString, reading the
+ * len characters starting at buf. The buffer is neither copied nor
+ * modified, so descriptions can be parsed straight from a file buffer.
+ *
+ * @param buf Start of the description.
+ * @param len Number of characters of the description.
+ *
+ * @return Return the initialized vertex if it was done correctly, 
+ * otherwise return NULL.
+*/
+Vertex *vertex_initFromBuffer(const char *buf, size_t len);
+
 /**
  * @brief Frees all memory associated to given vertex
  *
@@ -231,6 +260,19 @@ void * vertex_copy (const void * src);
  */
 int vertex_print (FILE * pf, const void * v);
 
+/**
+ * @brief Puts the data of a vertex in an OutBuf.
+ * 
+ * @author Izan Robles
+ * 
+ * Same format as vertex_print, for the functions that print many
+ * vertices through one OutBuf.
+ *
+ * @param ob OutBuf where the vertex is put
+ * @param v Vertex to be printed
+ */
+void vertex_write (OutBuf * ob, const void * v);
+
 /**
  * @brief Verifies if all the fields of a vertex are valid.
  * 
@@ -265,5 +307,85 @@ Status vertex_set_index(Vertex *v, int index);
  */
 int vertex_get_index(const Vertex *v);
 
+/**
+ * @brief Creates an empty vertex arena.
+ *
+ * @author Izan Robles
+ *
+ * Vertices are handed out from slabs that double in size up to 65536
+ * vertices, so loading n vertices takes O(log n + n / 65536) mallocs
+ * instead of n.
+ *
+ * @return The new arena, or NULL if there is not enough memory.
+ */
+VertexArena *vertex_arena_init();
+
+/**
+ * @brief Frees an arena and every vertex taken from it.
+ *
+ * @author Izan Robles
+ *
+ * @param a Arena to free.
+ */
+void vertex_arena_free(VertexArena *a);
+
+/**
+ * @brief Frees every vertex taken from an arena, keeping the arena.
+ *
+ * @author Izan Robles
+ *
+ * The largest slab is kept, so an arena that is cleared after every
+ * vertex does not allocate again.
+ *
+ * @param a Arena to clear.
+ */
+void vertex_arena_clear(VertexArena *a);
+
+/**
+ * @brief Same as vertex_init, taking the vertex from an arena.
+ *
+ * @author Izan Robles
+ *
+ * @param a Arena that owns the vertex.
+ *
+ * @return The new vertex, or NULL if there is any error.
+ */
+Vertex *vertex_arena_new(VertexArena *a);
+
+/**
+ * @brief Same as vertex_initFromString, taking the vertex from an arena.
+ *
+ * @author Izan Robles
+ *
+ * @param a Arena that owns the vertex.
+ * @param descr String describing the vertex.
+ *
+ * @return The new vertex, or NULL if there is any error.
+ */
+Vertex *vertex_arena_initFromString(VertexArena *a, char *descr);
+
+/**
+ * @brief Same as vertex_initFromBuffer, taking the vertex from an arena.
+ *
+ * @author Izan Robles
+ *
+ * @param a Arena that owns the vertex.
+ * @param buf Start of the description.
+ * @param len Number of characters of the description.
+ *
+ * @return The new vertex, or NULL if there is any error.
+ */
+Vertex *vertex_arena_initFromBuffer(VertexArena *a, const char *buf, size_t len);
+
+/**
+ * @brief Free function for vertices taken from an arena. It does
+ * nothing, so it can be passed where a p_element_free is expected.
+ *
+ * @author Izan Robles
+ *
+ * @param v Vertex taken from an arena.
+ */
+void vertex_arena_release(void *v);
+
 
 #endif /* VERTEX_H_ */